@@ -0,0 +1,94 @@
+/***************************************************************************************
+ *  Genesis Plus
+ *  State branching
+ *
+ *  Copyright (C) 2007-2020  Eke-Eke (Genesis Plus GX)
+ *
+ *  Redistribution and use of this code or any derivative works are permitted
+ *  provided that the following conditions are met:
+ *
+ *   - Redistributions may not be sold, nor may they be used in a commercial
+ *     product or activity.
+ *
+ *   - Redistributions that are modified from the original source must include the
+ *     complete source code, including the source code for all components used by a
+ *     binary built from the modified sources. However, as a special exception, the
+ *     source code distributed need not include anything that is normally distributed
+ *     (in either source or binary form) with the major components (compiler, kernel,
+ *     and so on) of the operating system on which the executable runs, unless that
+ *     component itself accompanies the executable.
+ *
+ *   - Redistributions must reproduce the above copyright notice, this list of
+ *     conditions and the following disclaimer in the documentation and/or other
+ *     materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************************/
+
+
+#include "shared.h"
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__)
+#include <unistd.h>
+#define HAVE_FORK
+#endif
+
+/* Emulation state is held in global variables, so branches are created as
+ * child processes sharing all memory copy-on-write with the parent: only
+ * pages modified by one branch (RAM, VRAM, ...) are actually duplicated,
+ * while cartridge ROM, lookup tables & caches stay shared. Each branch can
+ * then be run independently from the same starting point.
+ *
+ * Returns 0 in the new branch, the branch process id in the caller and -1
+ * if the branch could not be created (or if unsupported on this platform).
+ */
+int branch_fork(void)
+{
+#ifdef HAVE_FORK
+  pid_t pid;
+
+  /* background threads are not duplicated, stop them first */
+  if (system_hw == SYSTEM_MCD)
+  {
+    scd_threads_stop();
+    cdd_threads_stop();
+  }
+
+  pid = fork();
+
+  if (system_hw == SYSTEM_MCD)
+  {
+    if (pid == 0)
+    {
+      /* disc image file offsets are shared between processes, reopen them */
+      if (!cdd_reopen())
+      {
+        /* branch can not read disc image without interfering with caller */
+        _exit(1);
+      }
+    }
+    else
+    {
+      cdd_threads_start();
+    }
+
+    /* SUB-CPU thread is restarted in both processes */
+    scd_threads_start();
+  }
+
+  return pid;
+#else
+  return -1;
+#endif
+}
@@ -242,6 +242,53 @@ void cdc_dma_update(void)
   }
 }
 
+void cdc_dma_copy(uint8 *dst, uint32 dst_index, uint32 dst_mask, uint16 src_index, unsigned int words, int swap)
+{
+  /* transfer is only split when CDC buffer or destination address wraps */
+  while (words)
+  {
+    /* contiguous words in both CDC buffer and destination memory */
+    unsigned int length = (0x4000 - src_index) >> 1;
+    if (length > ((dst_mask + 2 - dst_index) >> 1))
+    {
+      length = (dst_mask + 2 - dst_index) >> 1;
+    }
+    if (length > words)
+    {
+      length = words;
+    }
+
+#ifdef LSB_FIRST
+    if (swap)
+    {
+      /* 16-bit words are stored in native byte order (simple loop is vectorized by compiler) */
+      uint16 *src = (uint16 *)(cdc.ram + src_index);
+      uint16 *ptr = (uint16 *)(dst + dst_index);
+      unsigned int i;
+      for (i=0; i<length; i++)
+      {
+        ptr[i] = (src[i] << 8) | (src[i] >> 8);
+      }
+    }
+    else
+#endif
+    {
+      memcpy(dst + dst_index, cdc.ram + src_index, length << 1);
+    }
+
+    /* increment CDC buffer source & destination addresses */
+    src_index = (src_index + (length << 1)) & 0x3ffe;
+    dst_index = (dst_index + (length << 1)) & dst_mask;
+    words -= length;
+  }
+}
+
+int cdc_decoder_ready(void)
+{
+  /* decoder interrupt acknowledged and no data transfer in progress */
+  return ((cdc.ifstat & (BIT_DECI | BIT_DTBSY)) == (BIT_DECI | BIT_DTBSY)) && !cdc.dma_w;
+}
+
 void cdc_decoder_update(uint32 header)
 {
   /* data decoding enabled ? */
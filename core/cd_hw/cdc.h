@@ -63,6 +63,8 @@ extern void cdc_reset(void);
 extern int cdc_context_save(uint8 *state);
 extern int cdc_context_load(uint8 *state);
 extern void cdc_dma_update(void);
+extern void cdc_dma_copy(uint8 *dst, uint32 dst_index, uint32 dst_mask, uint16 src_index, unsigned int words, int swap);
+extern int cdc_decoder_ready(void);
 extern void cdc_decoder_update(uint32 header);
 extern void cdc_reg_w(unsigned char data);
 extern unsigned char cdc_reg_r(void);
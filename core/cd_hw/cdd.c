@@ -37,6 +37,23 @@
  ****************************************************************************************/
 #include "shared.h"
 
+#if defined(HAVE_THREADS)
+#include <pthread.h>
+#endif
+
+/* disc image index files are only used when file modification time is available */
+#if defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__) || defined(_WIN32)
+#include <sys/stat.h>
+#define HAVE_STAT
+#endif
+
+#if defined(HAVE_MMAP)
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 static int cdd_get_audio_sample_difference(void);
 static int cdd_get_audio_sample_offset_lba(void);
 
@@ -103,98 +120,1439 @@ static const uint16 toc_lunar[52] =
   685, 3167
 };
 
-static const uint32 toc_shadow[15] =
+static const uint32 toc_shadow[15] =
+{
+  10226, 70054, 11100, 12532, 12444, 11923, 10059, 10167, 10138, 13792,
+  11637,  2547,  2521,  3856, 900
+};
+
+static const uint32 toc_dungeon[13] =
+{
+  2250, 22950, 16350, 24900, 13875, 19950, 13800, 15375, 17400, 17100,
+  3325,  6825, 25275
+};
+
+static const uint32 toc_ffight[26] =
+{
+  11994, 9742, 10136, 9685, 9553, 14588, 9430, 8721, 9975, 9764,
+  9704, 12796, 585, 754, 951, 624, 9047, 1068, 817, 9191, 1024,
+  14562, 10320, 8627, 3795, 3047
+};
+
+static const uint32 toc_ffightj[29] =
+{
+  11994, 9752, 10119, 9690, 9567, 14575, 9431, 8731, 9965, 9763,
+  9716, 12791, 579, 751, 958, 630, 9050, 1052, 825, 9193, 1026,
+  14553, 9834, 10542, 1699, 1792, 1781, 3783, 3052
+};
+
+
+/* supported audio file extensions */
+static const char extensions[SUPPORTED_EXT][16] =
+{
+#if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
+  "%02d.ogg",
+  " %02d.ogg",
+  "-%02d.ogg",
+  "_%02d.ogg",
+  " - %02d.ogg",
+  "%d.ogg",
+  " %d.ogg",
+  "-%d.ogg",
+  "_%d.ogg",
+  " - %d.ogg",
+#endif
+  "%02d.wav",
+  " %02d.wav",
+  "-%02d.wav",
+  "_%02d.wav",
+  " - %02d.wav",
+  "%d.wav",
+  " %d.wav",
+  "-%d.wav",
+  "_%d.wav",
+  " - %d.wav"
+};
+
+/* last loaded disc image & subcode file names (see cdd_reopen) */
+static char *image_filename;
+static char *sub_filename;
+
+/* disc image index file support (see cdd_set_index) */
+#define INDEX_FILE_ID "GPGXIDX1"
+static int index_enabled = 0;
+
+/* track file names & types (0: none, 1: BINARY or WAVE file, 2: VORBIS file) */
+static char *track_names[100];
+static uint8 track_kind[100];
+
+/* whole disc image preloading (see cdd_set_preload) */
+#define PRELOAD_THREADS_MAX 4
+static int preload_size = 0;  /* memory budget in MB (0 = disabled) */
+static struct
+{
+  uint8 *data;    /* track files (or decoded VORBIS tracks) & subcode data */
+  uint8 *sub;     /* subcode data */
+  int subsize;
+  int next;       /* next VORBIS track to decode */
+} preload;
+
+/* decoded subcode data cache */
+#define SUB_CACHE_SECTORS 75
+static struct
+{
+  int pos;        /* current .sub file offset */
+  int first;      /* first cached sector */
+  int count;      /* number of cached sectors (0 = empty) */
+  uint16 data[SUB_CACHE_SECTORS][48];
+} sub_cache;
+
+/* subcode deinterleaving lookup table (P subchannel bits of 4 consecutive 16-bit words) */
+static uint16 lut_sub[256][4];
+
+#if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
+
+static int seek64_wrap(void *f,ogg_int64_t off,int whence){
+  return cdStreamSeek(f,off,whence);
+}
+
+static ov_callbacks cb =
+{ 
+  (size_t (*)(void *, size_t, size_t, void *))  cdStreamRead,
+  (int (*)(void *, ogg_int64_t, int))           seek64_wrap,
+  (int (*)(void *))                             cdStreamClose,
+  (long (*)(void *))                            cdStreamTell
+};
+
+#ifdef DISABLE_MANY_OGG_OPEN_FILES
+static void ogg_free(int i)
+{
+  /* clear OGG file descriptor to prevent file from being closed */
+  cdd.toc.tracks[i].vf.datasource = NULL;
+
+  /* close VORBIS file structure */
+  ov_clear(&cdd.toc.tracks[i].vf);
+
+  /* indicates that the track is a seekable VORBIS file */
+  cdd.toc.tracks[i].vf.seekable = 1;
+
+  /* reset file reading position */
+  cdStreamSeek(cdd.toc.tracks[i].fd, 0, SEEK_SET);
+}
+#endif
+
+#if defined(HAVE_THREADS) && !defined(DISABLE_MANY_OGG_OPEN_FILES)
+
+/* VORBIS tracks are decoded by a background thread into a PCM ring buffer,   */
+/* ahead of playback position. Emulation only waits when samples are not yet  */
+/* decoded (i.e right after a seek, if playback starts immediately), so audio */
+/* output is identical to synchronous decoding. Recently played samples are   */
+/* kept in the buffer so that short backward seeks (state reloading) are free. */
+#define USE_OGG_THREAD
+
+#define OGG_RING_SIZE    0x10000  /* 16384 samples */
+#define OGG_RING_HISTORY 0x4000   /* played samples kept in buffer */
+#define OGG_CHUNK_SIZE   0x1000   /* maximal decoded chunk */
+
+static struct
+{
+  uint8 buffer[OGG_RING_SIZE];
+  int track;          /* decoded track (-1 if none) */
+  ogg_int64_t start;  /* stream offset of first decoded byte */
+  ogg_int64_t head;   /* stream offset of next decoded byte */
+  ogg_int64_t read;   /* stream offset of next played byte */
+  int seek;           /* seek request pending */
+  int eof;            /* end of track decoded */
+  int gen;            /* seek request counter */
+} ogg_ring = { {0}, -1 };
+
+static pthread_t ogg_thread;
+static pthread_mutex_t ogg_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ogg_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t ogg_done = PTHREAD_COND_INITIALIZER;
+static int ogg_thread_running;
+
+static void *ogg_decode_thread(void *arg)
+{
+  pthread_mutex_lock(&ogg_lock);
+
+  while (ogg_thread_running)
+  {
+    int len, ofs, gen = ogg_ring.gen;
+    OggVorbis_File *vf;
+
+    /* process seek request */
+    if (ogg_ring.seek)
+    {
+      ogg_int64_t pos = ogg_ring.start / 4;
+      vf = &cdd.toc.tracks[ogg_ring.track].vf;
+      ogg_ring.seek = 0;
+      pthread_mutex_unlock(&ogg_lock);
+      ov_pcm_seek(vf, pos);
+      pthread_mutex_lock(&ogg_lock);
+      continue;
+    }
+
+    /* wait until buffer needs to be filled */
+    if ((ogg_ring.track < 0) || ogg_ring.eof || ((ogg_ring.head - ogg_ring.read) >= (OGG_RING_SIZE - OGG_RING_HISTORY)))
+    {
+      pthread_cond_wait(&ogg_wake, &ogg_lock);
+      continue;
+    }
+
+    /* decode next chunk (overwritten samples are always outside played history) */
+    vf = &cdd.toc.tracks[ogg_ring.track].vf;
+    ofs = ogg_ring.head % OGG_RING_SIZE;
+    len = OGG_RING_SIZE - ofs;
+    if (len > OGG_CHUNK_SIZE)
+      len = OGG_CHUNK_SIZE;
+    pthread_mutex_unlock(&ogg_lock);
+#ifdef USE_LIBVORBIS
+    len = ov_read(vf, (char *)(ogg_ring.buffer + ofs), len, 0, 2, 1, 0);
+#else
+    len = ov_read(vf, (char *)(ogg_ring.buffer + ofs), len, 0);
+#endif
+    pthread_mutex_lock(&ogg_lock);
+
+    /* discard decoded samples if a new seek was requested meanwhile */
+    if (gen == ogg_ring.gen)
+    {
+      if (len > 0)
+        ogg_ring.head += len;
+      else
+        ogg_ring.eof = 1;
+      pthread_cond_signal(&ogg_done);
+    }
+  }
+
+  pthread_mutex_unlock(&ogg_lock);
+
+  return NULL;
+}
+#endif
+
+static void ogg_seek(int index, ogg_int64_t pos)
+{
+#ifdef USE_OGG_THREAD
+  if (ogg_thread_running)
+  {
+    pos *= 4;
+
+    pthread_mutex_lock(&ogg_lock);
+
+    /* check if requested samples are still in buffer */
+    if ((index == ogg_ring.track) && !ogg_ring.seek && (pos >= ogg_ring.start) && (pos <= ogg_ring.head) &&
+        (pos >= (ogg_ring.head + OGG_CHUNK_SIZE - OGG_RING_SIZE)))
+    {
+      ogg_ring.read = pos;
+    }
+    else
+    {
+      /* restart decoding from new position */
+      ogg_ring.track = index;
+      ogg_ring.start = ogg_ring.head = ogg_ring.read = pos;
+      ogg_ring.seek = 1;
+      ogg_ring.eof = 0;
+      ogg_ring.gen++;
+    }
+
+    pthread_cond_signal(&ogg_wake);
+    pthread_mutex_unlock(&ogg_lock);
+    return;
+  }
+#endif
+
+  ov_pcm_seek(&cdd.toc.tracks[index].vf, pos);
+}
+
+static int ogg_read(int index, uint8 *dst, int bytes)
+{
+#ifdef USE_OGG_THREAD
+  if (ogg_thread_running)
+  {
+    int len;
+
+    /* start decoding from current file position if track was never sought */
+    if (index != ogg_ring.track)
+    {
+      ogg_seek(index, ov_pcm_tell(&cdd.toc.tracks[index].vf));
+    }
+
+    pthread_mutex_lock(&ogg_lock);
+
+    /* wait for decoded samples */
+    while (ogg_ring.seek || ((ogg_ring.head == ogg_ring.read) && !ogg_ring.eof))
+    {
+      pthread_cond_wait(&ogg_done, &ogg_lock);
+    }
+
+    /* copy available samples */
+    len = ogg_ring.head - ogg_ring.read;
+    if (len > bytes)
+      len = bytes;
+    if (len > 0)
+    {
+      int ofs = ogg_ring.read % OGG_RING_SIZE;
+      int size = OGG_RING_SIZE - ofs;
+      if (size > len)
+        size = len;
+      memcpy(dst, ogg_ring.buffer + ofs, size);
+      memcpy(dst + size, ogg_ring.buffer, len - size);
+      ogg_ring.read += len;
+    }
+
+    pthread_cond_signal(&ogg_wake);
+    pthread_mutex_unlock(&ogg_lock);
+    return len;
+  }
+#endif
+
+#ifdef USE_LIBVORBIS
+  return ov_read(&cdd.toc.tracks[index].vf, (char *)dst, bytes, 0, 2, 1, 0);
+#else
+  return ov_read(&cdd.toc.tracks[index].vf, (char *)dst, bytes, 0);
+#endif
+}
+
+#endif
+
+#if defined(USE_LIBCHDR)
+
+/* Decompressed CHD hunks are kept in a LRU cache, or the whole disc image is */
+/* preloaded. When threads are available, a pool of threads, each one with   */
+/* its own CHD file handle & codecs, decompresses next hunks along current    */
+/* reading direction (and remaining hunks when the whole image is preloaded) */
+/* so that emulation only waits on real cache misses.                         */
+#define CHD_CACHE_MAX   64
+#define CHD_THREADS_MAX 8
+
+/* CHD cache slot state */
+#define SLOT_EMPTY   0
+#define SLOT_LOADING 1
+#define SLOT_READY   2
+
+static struct
+{
+  uint8 *data;    /* decompressed hunks buffer */
+  int *slot;      /* slot index of each hunk (-1 if not cached) */
+  int *hunk;      /* hunk index of each slot */
+  uint8 *state;   /* slot state */
+  uint32 *used;   /* slot last access time */
+  uint32 clock;   /* access counter */
+  int slots;      /* number of cache slots */
+  int pinned;     /* slot currently accessed by emulation */
+  int last;       /* last accessed hunk */
+  int dir;        /* reading direction (+1/-1) */
+  int total;      /* total number of hunks */
+  int preload;    /* next hunk to preload (whole image cache only) */
+} chd_cache;
+
+/* cache slots & decoding threads used for next loaded CHD file */
+static int chd_cache_size = 16;
+static int chd_threads_count = 1;
+
+#if defined(HAVE_THREADS)
+static pthread_t chd_threads[CHD_THREADS_MAX];
+static chd_file *chd_threads_file[CHD_THREADS_MAX];
+static cdStream *chd_threads_fd[CHD_THREADS_MAX];
+static pthread_mutex_t chd_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t chd_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t chd_done = PTHREAD_COND_INITIALIZER;
+static int chd_threads_running;
+static int chd_threads_num;
+#define CHD_LOCK()   pthread_mutex_lock(&chd_lock)
+#define CHD_UNLOCK() pthread_mutex_unlock(&chd_lock)
+#else
+#define CHD_LOCK()
+#define CHD_UNLOCK()
+#endif
+
+static int chd_cache_victim(int hunknum, int prefetch)
+{
+  int i, slot = -1;
+  uint32 age = 0;
+
+  /* whole image cache */
+  if (chd_cache.slots == chd_cache.total)
+    return hunknum;
+
+  for (i=0; i<chd_cache.slots; i++)
+  {
+    /* skip slots being decoded */
+    if (chd_cache.state[i] == SLOT_LOADING)
+      continue;
+
+    /* use empty slots first */
+    if (chd_cache.state[i] == SLOT_EMPTY)
+      return i;
+
+    if (prefetch)
+    {
+      /* distance from current hunk along reading direction */
+      int dist = (chd_cache.hunk[i] - chd_cache.last) * chd_cache.dir;
+
+      /* never evict current hunk or hunks already prefetched */
+      if ((i == chd_cache.pinned) || ((dist > 0) && (dist <= (chd_cache.slots / 2))))
+        continue;
+    }
+
+    /* least recently used slot */
+    if ((slot < 0) || ((uint32)(chd_cache.clock - chd_cache.used[i]) > age))
+    {
+      age = chd_cache.clock - chd_cache.used[i];
+      slot = i;
+    }
+  }
+
+  return slot;
+}
+
+static void chd_cache_assign(int slot, int hunknum)
+{
+  /* evict previously cached hunk */
+  if (chd_cache.state[slot] != SLOT_EMPTY)
+    chd_cache.slot[chd_cache.hunk[slot]] = -1;
+
+  chd_cache.slot[hunknum] = slot;
+  chd_cache.hunk[slot] = hunknum;
+  chd_cache.state[slot] = SLOT_LOADING;
+}
+
+static uint8 *chd_cache_get(int hunknum)
+{
+  int slot;
+
+  CHD_LOCK();
+
+  /* update reading direction */
+  if (hunknum != chd_cache.last)
+  {
+    chd_cache.dir = (hunknum < chd_cache.last) ? -1 : 1;
+    chd_cache.last = hunknum;
+  }
+
+  for (;;)
+  {
+    slot = chd_cache.slot[hunknum];
+
+    /* cache hit */
+    if ((slot >= 0) && (chd_cache.state[slot] == SLOT_READY))
+      break;
+
+    /* cache miss */
+    if (slot < 0)
+    {
+      slot = chd_cache_victim(hunknum, 0);
+      if (slot >= 0)
+      {
+        chd_cache_assign(slot, hunknum);
+        CHD_UNLOCK();
+        chd_read(cdd.chd.file, hunknum, chd_cache.data + (slot * cdd.chd.hunkbytes));
+        CHD_LOCK();
+        chd_cache.state[slot] = SLOT_READY;
+        break;
+      }
+    }
+
+#if defined(HAVE_THREADS)
+    /* wait until hunk (or any other slot) is decoded */
+    pthread_cond_wait(&chd_done, &chd_lock);
+#endif
+  }
+
+  chd_cache.used[slot] = ++chd_cache.clock;
+  chd_cache.pinned = slot;
+
+#if defined(HAVE_THREADS)
+  /* restart decoding from current hunk */
+  pthread_cond_broadcast(&chd_wake);
+#endif
+
+  CHD_UNLOCK();
+
+  return chd_cache.data + (slot * cdd.chd.hunkbytes);
+}
+
+#if defined(HAVE_THREADS)
+static int chd_cache_next(void)
+{
+  int i;
+  int depth = (chd_cache.slots == chd_cache.total) ? (CHD_CACHE_MAX / 2) : (chd_cache.slots / 2);
+
+  /* next hunks along reading direction */
+  for (i=1; i<=depth; i++)
+  {
+    int next = chd_cache.last + (i * chd_cache.dir);
+    if ((next < 0) || (next >= chd_cache.total))
+      break;
+    if (chd_cache.slot[next] < 0)
+      return next;
+  }
+
+  /* remaining hunks when whole image is preloaded */
+  if (chd_cache.slots == chd_cache.total)
+  {
+    while (chd_cache.preload < chd_cache.total)
+    {
+      if (chd_cache.slot[chd_cache.preload] < 0)
+        return chd_cache.preload;
+      chd_cache.preload++;
+    }
+  }
+
+  return -1;
+}
+
+static void *chd_decode_thread(void *arg)
+{
+  chd_file *file = (chd_file *)arg;
+
+  CHD_LOCK();
+
+  while (chd_threads_running)
+  {
+    int slot = -1;
+    int hunknum = chd_cache_next();
+
+    if (hunknum >= 0)
+      slot = chd_cache_victim(hunknum, 1);
+
+    /* wait for next hunk access */
+    if (slot < 0)
+    {
+      pthread_cond_wait(&chd_wake, &chd_lock);
+      continue;
+    }
+
+    chd_cache_assign(slot, hunknum);
+    CHD_UNLOCK();
+    chd_read(file, hunknum, chd_cache.data + (slot * cdd.chd.hunkbytes));
+    CHD_LOCK();
+    chd_cache.state[slot] = SLOT_READY;
+    chd_cache.used[slot] = ++chd_cache.clock;
+    pthread_cond_broadcast(&chd_done);
+  }
+
+  CHD_UNLOCK();
+
+  return NULL;
+}
+#endif
+
+static void chd_cache_free(void)
+{
+  cdd_threads_stop();
+
+  free(chd_cache.data);
+  free(chd_cache.slot);
+  free(chd_cache.hunk);
+  free(chd_cache.state);
+  free(chd_cache.used);
+  memset(&chd_cache, 0, sizeof(chd_cache));
+}
+
+static int chd_cache_init(int hunkbytes, int hunks)
+{
+  int i;
+
+  /* whole image cache (fallback to default cache size if not enough memory) */
+  chd_cache.slots = (!chd_cache_size || (chd_cache_size > hunks)) ? hunks : chd_cache_size;
+  if (preload_size && (((uint32)hunks * hunkbytes) <= ((uint32)preload_size << 20)))
+  {
+    /* whole image fits within preloading memory budget */
+    chd_cache.slots = hunks;
+  }
+  chd_cache.data = (uint8 *)malloc((size_t)chd_cache.slots * hunkbytes);
+  if (!chd_cache.data && (chd_cache.slots > 16))
+  {
+    chd_cache.slots = 16;
+    chd_cache.data = (uint8 *)malloc(chd_cache.slots * hunkbytes);
+  }
+
+  chd_cache.slot = (int *)malloc(hunks * sizeof(int));
+  chd_cache.hunk = (int *)malloc(chd_cache.slots * sizeof(int));
+  chd_cache.state = (uint8 *)malloc(chd_cache.slots);
+  chd_cache.used = (uint32 *)malloc(chd_cache.slots * sizeof(uint32));
+
+  if (!chd_cache.data || !chd_cache.slot || !chd_cache.hunk || !chd_cache.state || !chd_cache.used)
+  {
+    chd_cache_free();
+    return 0;
+  }
+
+  for (i=0; i<hunks; i++)
+  {
+    chd_cache.slot[i] = -1;
+  }
+
+  for (i=0; i<chd_cache.slots; i++)
+  {
+    chd_cache.hunk[i] = -1;
+    chd_cache.state[i] = SLOT_EMPTY;
+    chd_cache.used[i] = 0;
+  }
+
+  chd_cache.clock = 0;
+  chd_cache.pinned = -1;
+  chd_cache.last = 0;
+  chd_cache.dir = 1;
+  chd_cache.total = hunks;
+  chd_cache.preload = 0;
+  return 1;
+}
+
+static void chd_cache_preload(void)
+{
+  int i;
+
+#if defined(HAVE_THREADS)
+  /* whole image is decompressed in background (unless preloading is requested) */
+  if (chd_threads_num && !preload_size)
+    return;
+#endif
+
+  if (chd_cache.slots == chd_cache.total)
+  {
+    /* background threads also decompress remaining hunks in parallel */
+    for (i=0; i<chd_cache.total; i++)
+    {
+      chd_cache_get(i);
+    }
+
+    /* restart reading from first hunk */
+    CHD_LOCK();
+    chd_cache.last = 0;
+    chd_cache.dir = 1;
+    CHD_UNLOCK();
+  }
+}
+
+#endif
+
+static void track_map(int index, const char *filename)
+{
+#if defined(HAVE_MMAP)
+  /* map local BIN/ISO/WAVE track file so that sectors are read directly from page cache */
+  struct stat st;
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+  {
+    /* not a local file (keep using file stream) */
+    return;
+  }
+
+  if (!fstat(fd, &st) && S_ISREG(st.st_mode) && (st.st_size > 0) && (st.st_size < 0x7fffffff))
+  {
+    void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map != MAP_FAILED)
+    {
+#if defined(MADV_WILLNEED)
+      /* let the kernel read ahead */
+      madvise(map, st.st_size, MADV_WILLNEED);
+#endif
+      cdd.toc.tracks[index].map = (uint8 *)map;
+      cdd.toc.tracks[index].mapsize = st.st_size;
+      cdd.toc.tracks[index].mappos = 0;
+    }
+  }
+
+  /* mapping remains valid after file is closed */
+  close(fd);
+#endif
+}
+
+static void track_seek(int index, int offset)
+{
+  if (cdd.toc.tracks[index].map)
+  {
+    cdd.toc.tracks[index].mappos = offset;
+    return;
+  }
+  cdStreamSeek(cdd.toc.tracks[index].fd, offset, SEEK_SET);
+}
+
+static uint8 *track_data(int index, int size)
+{
+  /* return pointer to track data in memory at current position (NULL if not available) */
+  int pos = cdd.toc.tracks[index].mappos;
+  if (cdd.toc.tracks[index].map && (pos >= 0) && (pos <= (cdd.toc.tracks[index].mapsize - size)))
+  {
+    cdd.toc.tracks[index].mappos = pos + size;
+    return cdd.toc.tracks[index].map + pos;
+  }
+  return NULL;
+}
+
+static void track_read(int index, uint8 *dst, int size)
+{
+  if (cdd.toc.tracks[index].map)
+  {
+    /* copy available data, clear anything beyond end of file */
+    int pos = cdd.toc.tracks[index].mappos;
+    int len = cdd.toc.tracks[index].mapsize - pos;
+    if ((pos < 0) || (len < 0))
+    {
+      len = 0;
+    }
+    else if (len > size)
+    {
+      len = size;
+    }
+    memcpy(dst, cdd.toc.tracks[index].map + pos, len);
+    memset(dst + len, 0, size - len);
+    cdd.toc.tracks[index].mappos = pos + size;
+    return;
+  }
+  cdStreamRead(dst, 1, size, cdd.toc.tracks[index].fd);
+}
+
+static void sub_seek(int offset)
+{
+  sub_cache.pos = offset;
+}
+
+static void sub_decode(uint16 *dst, const uint8 *src)
+{
+  int i,j;
+
+  /* convert interleaved subcode data (12 x 8-bit of P subchannel first, then Q subchannel, etc) */
+  /* back to raw subcode format (96 bytes with 8 x P-W subchannel bits per byte) */
+  for (i=0; i<12; i++)
+  {
+    const uint16 *lut = lut_sub[src[i]];
+    uint16 code[4];
+    code[0] = lut[0];
+    code[1] = lut[1];
+    code[2] = lut[2];
+    code[3] = lut[3];
+    for (j=1; j<8; j++)
+    {
+      lut = lut_sub[src[(j*12)+i]];
+      code[0] |= (lut[0] >> j);
+      code[1] |= (lut[1] >> j);
+      code[2] |= (lut[2] >> j);
+      code[3] |= (lut[3] >> j);
+    }
+    *dst++ = code[0];
+    *dst++ = code[1];
+    *dst++ = code[2];
+    *dst++ = code[3];
+  }
+}
+
+static const uint16 *sub_read(void)
+{
+  int sector = sub_cache.pos / 96;
+  sub_cache.pos += 96;
+
+  if (sector < 0)
+  {
+    /* no subcode data before start of file */
+    static const uint16 blank[48];
+    return blank;
+  }
+
+  /* decode subcode data by chunks of consecutive sectors */
+  if ((sector < sub_cache.first) || (sector >= (sub_cache.first + sub_cache.count)))
+  {
+    uint8 buf[SUB_CACHE_SECTORS * 96];
+    int i, len;
+
+    sub_cache.first = sector - (sector % SUB_CACHE_SECTORS);
+    sub_cache.count = SUB_CACHE_SECTORS;
+
+    if (preload.sub)
+    {
+      len = preload.subsize - (sub_cache.first * 96);
+      if (len > (int)sizeof(buf)) len = sizeof(buf);
+      if (len < 0) len = 0;
+      memcpy(buf, preload.sub + (sub_cache.first * 96), len);
+    }
+    else
+    {
+      cdStreamSeek(cdd.toc.sub, sub_cache.first * 96, SEEK_SET);
+      len = cdStreamRead(buf, 1, sizeof(buf), cdd.toc.sub);
+      if (len < 0) len = 0;
+    }
+
+    /* cleared beyond end of file */
+    memset(buf + len, 0, sizeof(buf) - len);
+
+    for (i=0; i<SUB_CACHE_SECTORS; i++)
+    {
+      sub_decode(sub_cache.data[i], buf + (i * 96));
+    }
+  }
+
+  return sub_cache.data[sector - sub_cache.first];
+}
+
+static void file_name(char **name, const char *filename)
+{
+  /* keep a copy of file name (any length) */
+  free(*name);
+  *name = NULL;
+  if (filename)
+  {
+    *name = malloc(strlen(filename) + 1);
+    if (*name)
+    {
+      strcpy(*name, filename);
+    }
+  }
+}
+
+static void track_name(int index, const char *filename)
+{
+  /* keep track file name (see cdd_index_save) */
+  file_name(&track_names[index], filename);
+}
+
+static void track_open(int index)
+{
+  int i;
+  cdStream *fd;
+
+  /* track files are only opened on first access when TOC was loaded from index file */
+  if ((index >= cdd.toc.last) || !track_kind[index] || !track_names[index] || cdd.toc.tracks[index].fd)
+  {
+    return;
+  }
+
+  /* check if a single file is used for several tracks */
+  if (track_kind[index] == 1)
+  {
+    for (i=0; i<cdd.toc.last; i++)
+    {
+      if ((track_kind[i] == 1) && cdd.toc.tracks[i].fd && !strcmp(track_names[i], track_names[index]))
+      {
+        /* use common file descriptor */
+        cdd.toc.tracks[index].fd = cdd.toc.tracks[i].fd;
+        cdd.toc.tracks[index].map = cdd.toc.tracks[i].map;
+        cdd.toc.tracks[index].mapsize = cdd.toc.tracks[i].mapsize;
+        return;
+      }
+    }
+  }
+
+  /* open track file */
+  fd = cdStreamOpen(track_names[index]);
+  if (!fd)
+  {
+    return;
+  }
+
+#if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
+  if (track_kind[index] == 2)
+  {
+#ifdef DISABLE_MANY_OGG_OPEN_FILES
+    /* VORBIS file structure is opened when track is played */
+    cdd.toc.tracks[index].vf.seekable = 1;
+#else
+    if (ov_open_callbacks(fd,&cdd.toc.tracks[index].vf,0,0,cb))
+    {
+      /* invalid VORBIS file */
+      cdStreamClose(fd);
+      return;
+    }
+#endif
+    cdd.toc.tracks[index].fd = fd;
+
+    /* start VORBIS tracks decoding in background */
+    cdd_threads_start();
+    return;
+  }
+#endif
+
+  /* BINARY or WAVE file */
+  cdd.toc.tracks[index].fd = fd;
+  track_map(index, track_names[index]);
+}
+
+static int file_key(const char *filename, uint32 *key)
+{
+#if defined(HAVE_STAT)
+  /* file size & modification time */
+  struct stat st;
+  if (stat(filename, &st))
+  {
+    return 0;
+  }
+  key[0] = (uint32)st.st_size;
+  key[1] = (uint32)st.st_mtime;
+  return 1;
+#else
+  /* index file can not be checked against disc image files */
+  return 0;
+#endif
+}
+
+static void cdd_index_save(const char *subname, int isCDfile)
+{
+  char name[256+4];
+  uint32 data[6];
+  cdStream *f;
+  int i;
+
+  /* disc image file key & TOC infos (index file name must fit in buffer) */
+  if ((strlen(image_filename) > 255) || !file_key(image_filename, data))
+  {
+    return;
+  }
+  data[2] = isCDfile;
+  data[3] = cdd.sectorSize;
+  data[4] = cdd.toc.last;
+  data[5] = cdd.toc.end;
+
+  sprintf(name, "%s.idx", image_filename);
+  f = cdStreamCreate(name);
+  if (!f)
+  {
+    /* read-only storage */
+    return;
+  }
+
+  cdStreamWrite(INDEX_FILE_ID, 8, 1, f);
+  cdStreamWrite(data, 4, 6, f);
+
+  /* subcode file name */
+  data[0] = strlen(subname);
+  cdStreamWrite(data, 4, 1, f);
+  cdStreamWrite(subname, 1, data[0], f);
+
+  /* tracks infos */
+  for (i=0; i<cdd.toc.last; i++)
+  {
+    data[0] = cdd.toc.tracks[i].start;
+    data[1] = cdd.toc.tracks[i].end;
+    data[2] = cdd.toc.tracks[i].offset;
+    data[3] = cdd.toc.tracks[i].type;
+    data[4] = 0;
+    data[5] = 0;
+
+    /* track file infos */
+    if (cdd.toc.tracks[i].fd && track_names[i])
+    {
+#if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
+      data[4] = cdd.toc.tracks[i].vf.seekable ? 2 : 1;
+#else
+      data[4] = 1;
+#endif
+      data[5] = strlen(track_names[i]);
+    }
+
+    cdStreamWrite(data, 4, 6, f);
+
+    if (data[4])
+    {
+      /* track file name & key (checked on next load) */
+      cdStreamWrite(track_names[i], 1, data[5], f);
+      if (!file_key(track_names[i], data))
+      {
+        data[0] = data[1] = 0;
+      }
+      cdStreamWrite(data, 4, 2, f);
+    }
+  }
+
+  cdStreamClose(f);
+}
+
+static int cdd_index_load(char *header, char *subname)
+{
+  char name[256+4];
+  char sub[256];
+  uint32 data[6];
+  uint32 key[2];
+  cdStream *fd;
+  int i, last, isCDfile;
+
+  /* index file name must fit in buffer */
+  if (strlen(image_filename) > 255)
+  {
+    return -1;
+  }
+
+  sprintf(name, "%s.idx", image_filename);
+  fd = cdStreamOpen(name);
+  if (!fd)
+  {
+    return -1;
+  }
+
+  /* check index file is up to date with disc image file */
+  if ((cdStreamRead(name, 1, 8, fd) != 8) || memcmp(name, INDEX_FILE_ID, 8) ||
+      (cdStreamRead(data, 1, 24, fd) != 24) || !file_key(image_filename, key) ||
+      (data[0] != key[0]) || (data[1] != key[1]) || !data[4] || (data[4] > 99) ||
+      ((data[3] != 2048) && (data[3] != 2352)) || (data[5] >= 100*60*75))
+  {
+    cdStreamClose(fd);
+    return -1;
+  }
+
+  isCDfile = data[2];
+  last = data[4];
+  cdd.sectorSize = data[3];
+  cdd.toc.end = data[5];
+
+  /* subcode file name */
+  if ((cdStreamRead(data, 1, 4, fd) != 4) || (data[0] < 4) || (data[0] > 255) || (cdStreamRead(sub, 1, data[0], fd) != data[0]))
+  {
+    last = 0;
+  }
+  else
+  {
+    sub[data[0]] = 0;
+  }
+
+  /* tracks infos */
+  for (i=0; i<last; i++)
+  {
+    /* track limits must be within disc limits */
+    if ((cdStreamRead(data, 1, 24, fd) != 24) || (data[4] > 2) || (data[5] > 255) ||
+        (data[0] > data[1]) || (data[1] > (uint32)cdd.toc.end))
+    {
+      break;
+    }
+
+    cdd.toc.tracks[i].start = data[0];
+    cdd.toc.tracks[i].end = data[1];
+    cdd.toc.tracks[i].offset = data[2];
+    cdd.toc.tracks[i].type = data[3];
+    track_kind[i] = data[4];
+
+    if (track_kind[i])
+    {
+      /* track file must not have been modified */
+      if ((cdStreamRead(name, 1, data[5], fd) != data[5]) || (cdStreamRead(data, 1, 8, fd) != 8))
+      {
+        break;
+      }
+      name[data[5]] = 0;
+      if (!file_key(name, key) || (data[0] != key[0]) || (data[1] != key[1]))
+      {
+        break;
+      }
+      track_name(i, name);
+    }
+  }
+
+  cdStreamClose(fd);
+
+  cdd.toc.last = last;
+
+  /* first track file is opened immediately */
+  if (i == last)
+  {
+    track_open(0);
+  }
+
+  if ((i < last) || !cdd.toc.tracks[0].fd)
+  {
+    /* invalid index file */
+    for (i=0; i<100; i++)
+    {
+      track_name(i, NULL);
+    }
+    memset(track_kind, 0, sizeof(track_kind));
+    memset(&cdd.toc, 0x00, sizeof(cdd.toc));
+    cdd.sectorSize = 0;
+    return -1;
+  }
+
+  if (cdd.toc.tracks[0].type)
+  {
+    /* read CD image header + security code */
+    track_seek(0, (cdd.sectorSize == 2352) ? 0x10 : 0);
+    track_read(0, (uint8 *)header, 0x210);
+    track_seek(0, 0);
+  }
+
+  /* subcode file name */
+  strcpy(subname, sub);
+
+  return isCDfile;
+}
+
+#if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
+static void preload_ogg_track(int index)
+{
+  /* decode whole VORBIS track into 16-bit stereo samples */
+  OggVorbis_File *vf = &cdd.toc.tracks[index].vf;
+  uint8 *dst = cdd.toc.tracks[index].map;
+  int size = cdd.toc.tracks[index].mapsize;
+  int len, pos = 0;
+
+  ov_pcm_seek(vf, 0);
+  while (pos < size)
+  {
+#ifdef USE_LIBVORBIS
+    len = ov_read(vf, (char *)dst + pos, size - pos, 0, 2, 1, 0);
+#else
+    len = ov_read(vf, (char *)dst + pos, size - pos, 0);
+#endif
+    if (len <= 0)
+      break;
+    pos += len;
+  }
+  memset(dst + pos, 0, size - pos);
+
+#ifndef LSB_FIRST
+  /* preloaded tracks are read as little-endian PCM data */
+  for (len=0; len<pos; len+=2)
+  {
+    uint8 temp = dst[len];
+    dst[len] = dst[len + 1];
+    dst[len + 1] = temp;
+  }
+#endif
+}
+
+static void *preload_ogg_thread(void *arg)
+{
+#if defined(HAVE_THREADS)
+  static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+  int index;
+
+  for (;;)
+  {
+    /* next VORBIS track */
+#if defined(HAVE_THREADS)
+    pthread_mutex_lock(&lock);
+#endif
+    while ((preload.next < cdd.toc.last) && !cdd.toc.tracks[preload.next].vf.datasource)
+      preload.next++;
+    index = preload.next++;
+#if defined(HAVE_THREADS)
+    pthread_mutex_unlock(&lock);
+#endif
+
+    if (index >= cdd.toc.last)
+      return NULL;
+
+    preload_ogg_track(index);
+  }
+}
+#endif
+
+static void cdd_preload(void)
+{
+  int i, j, len[100];
+  size_t size = 0;
+  uint8 *ptr;
+
+  /* all track files need to be opened */
+  for (i=0; i<cdd.toc.last; i++)
+  {
+    track_open(i);
+  }
+
+  /* VORBIS tracks are fully decoded here */
+  cdd_threads_stop();
+
+  /* compute needed memory */
+  for (i=0; i<cdd.toc.last; i++)
+  {
+    len[i] = 0;
+
+    /* skip tracks without file or sharing file with a previous track */
+    for (j=0; (j<i) && (cdd.toc.tracks[j].fd != cdd.toc.tracks[i].fd); j++);
+    if (!cdd.toc.tracks[i].fd || (j < i))
+      continue;
+
+#if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
+    if (cdd.toc.tracks[i].vf.seekable)
+    {
+#ifdef DISABLE_MANY_OGG_OPEN_FILES
+      /* VORBIS file need to be opened first */
+      if (!cdd.toc.tracks[i].vf.datasource)
+      {
+        ov_open_callbacks(cdd.toc.tracks[i].fd,&cdd.toc.tracks[i].vf,0,0,cb);
+      }
+#endif
+      if (cdd.toc.tracks[i].vf.datasource)
+      {
+        len[i] = ov_pcm_total(&cdd.toc.tracks[i].vf,-1) * 4;
+        if (len[i] < 0)
+          len[i] = 0;
+      }
+    }
+    else
+#endif
+    if (cdd.toc.tracks[i].map)
+    {
+      len[i] = cdd.toc.tracks[i].mapsize;
+    }
+    else
+    {
+      cdStreamSeek(cdd.toc.tracks[i].fd, 0, SEEK_END);
+      len[i] = cdStreamTell(cdd.toc.tracks[i].fd);
+    }
+
+    size += len[i];
+  }
+
+  if (cdd.toc.sub)
+  {
+    cdStreamSeek(cdd.toc.sub, 0, SEEK_END);
+    preload.subsize = cdStreamTell(cdd.toc.sub);
+    size += preload.subsize;
+  }
+
+  /* keep streaming from files if disc image does not fit within memory budget */
+  if (!size || (size > ((size_t)preload_size << 20)) || !(preload.data = (uint8 *)malloc(size)))
+  {
+#if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
+#ifdef DISABLE_MANY_OGG_OPEN_FILES
+    for (i=0; i<cdd.toc.last; i++)
+    {
+      if (cdd.toc.tracks[i].vf.datasource)
+      {
+        ogg_free(i);
+      }
+    }
+#endif
+#endif
+    preload.subsize = 0;
+    return;
+  }
+
+  ptr = preload.data;
+
+  /* copy track files in memory */
+  for (i=0; i<cdd.toc.last; i++)
+  {
+    if (!cdd.toc.tracks[i].fd)
+      continue;
+
+    for (j=0; (j<i) && (cdd.toc.tracks[j].fd != cdd.toc.tracks[i].fd); j++);
+    if (j < i)
+    {
+      /* use common file data */
+      cdd.toc.tracks[i].map = cdd.toc.tracks[j].map;
+      cdd.toc.tracks[i].mapsize = cdd.toc.tracks[j].mapsize;
+      continue;
+    }
+
+#if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
+    if (cdd.toc.tracks[i].vf.seekable)
+    {
+      /* VORBIS track is decoded below & then read as PCM track (file offset in bytes) */
+      cdd.toc.tracks[i].offset *= 4;
+    }
+    else
+#endif
+    if (cdd.toc.tracks[i].map)
+    {
+      memcpy(ptr, cdd.toc.tracks[i].map, len[i]);
+#if defined(HAVE_MMAP)
+      munmap(cdd.toc.tracks[i].map, cdd.toc.tracks[i].mapsize);
+#endif
+    }
+    else
+    {
+      cdStreamSeek(cdd.toc.tracks[i].fd, 0, SEEK_SET);
+      cdStreamRead(ptr, 1, len[i], cdd.toc.tracks[i].fd);
+    }
+
+    cdd.toc.tracks[i].map = ptr;
+    cdd.toc.tracks[i].mapsize = len[i];
+    cdd.toc.tracks[i].mappos = 0;
+    ptr += len[i];
+  }
+
+  /* copy subcode file in memory */
+  if (cdd.toc.sub)
+  {
+    cdStreamSeek(cdd.toc.sub, 0, SEEK_SET);
+    cdStreamRead(ptr, 1, preload.subsize, cdd.toc.sub);
+    preload.sub = ptr;
+  }
+
+#if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
+  /* decode VORBIS tracks in parallel */
+  preload.next = 0;
+  {
+#if defined(HAVE_THREADS)
+    pthread_t threads[PRELOAD_THREADS_MAX];
+    int count;
+    for (count=0; count<PRELOAD_THREADS_MAX; count++)
+    {
+      if (pthread_create(&threads[count], NULL, preload_ogg_thread, NULL) != 0)
+        break;
+    }
+#endif
+    preload_ogg_thread(NULL);
+#if defined(HAVE_THREADS)
+    while (count--)
+    {
+      pthread_join(threads[count], NULL);
+    }
+#endif
+  }
+
+  /* close VORBIS file structures (files are closed on unload) */
+  for (i=0; i<cdd.toc.last; i++)
+  {
+    if (cdd.toc.tracks[i].vf.seekable)
+    {
+      cdd.toc.tracks[i].vf.datasource = NULL;
+      ov_clear(&cdd.toc.tracks[i].vf);
+      cdd.toc.tracks[i].vf.seekable = 0;
+    }
+  }
+#endif
+}
+
+void cdd_set_preload(int megabytes)
 {
-  10226, 70054, 11100, 12532, 12444, 11923, 10059, 10167, 10138, 13792,
-  11637,  2547,  2521,  3856, 900
-};
+  /* applied on next disc image loading (0 = disabled) */
+  preload_size = (megabytes < 0) ? 0 : megabytes;
+}
 
-static const uint32 toc_dungeon[13] =
+void cdd_set_index(int enable)
 {
-  2250, 22950, 16350, 24900, 13875, 19950, 13800, 15375, 17400, 17100,
-  3325,  6825, 25275
-};
+  /* applied on next disc image loading */
+  index_enabled = enable;
+}
 
-static const uint32 toc_ffight[26] =
+void cdd_set_chd_cache(int hunks, int threads)
 {
-  11994, 9742, 10136, 9685, 9553, 14588, 9430, 8721, 9975, 9764,
-  9704, 12796, 585, 754, 951, 624, 9047, 1068, 817, 9191, 1024,
-  14562, 10320, 8627, 3795, 3047
-};
+#if defined(USE_LIBCHDR)
+  /* applied on next disc image loading (0 = whole image) */
+  chd_cache_size = (hunks < 0) ? 1 : ((hunks > CHD_CACHE_MAX) ? CHD_CACHE_MAX : hunks);
+  chd_threads_count = (threads < 0) ? 0 : ((threads > CHD_THREADS_MAX) ? CHD_THREADS_MAX : threads);
+#endif
+}
 
-static const uint32 toc_ffightj[29] =
+void cdd_threads_start(void)
 {
-  11994, 9752, 10119, 9690, 9567, 14575, 9431, 8731, 9965, 9763,
-  9716, 12791, 579, 751, 958, 630, 9050, 1052, 825, 9193, 1026,
-  14553, 9834, 10542, 1699, 1792, 1781, 3783, 3052
-};
+#if defined(USE_LIBCHDR) && defined(HAVE_THREADS)
+  /* background decoding requires enough cache slots to stay ahead of emulation */
+  if (chd_cache.data && (chd_cache.slots >= 4) && !chd_threads_running)
+  {
+    int i;
 
+    chd_threads_running = 1;
 
-/* supported audio file extensions */
-static const char extensions[SUPPORTED_EXT][16] =
-{
-#if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
-  "%02d.ogg",
-  " %02d.ogg",
-  "-%02d.ogg",
-  "_%02d.ogg",
-  " - %02d.ogg",
-  "%d.ogg",
-  " %d.ogg",
-  "-%d.ogg",
-  "_%d.ogg",
-  " - %d.ogg",
+    for (i=0; i<chd_threads_count; i++)
+    {
+      /* each thread uses its own file handle & decompression codecs */
+      chd_threads_file[i] = NULL;
+      chd_threads_fd[i] = cdStreamOpen(image_filename);
+      if (!chd_threads_fd[i])
+        break;
+
+      if (chd_open_file(chd_threads_fd[i], CHD_OPEN_READ, NULL, &chd_threads_file[i]) != CHDERR_NONE)
+      {
+        cdStreamClose(chd_threads_fd[i]);
+        break;
+      }
+
+      if (pthread_create(&chd_threads[i], NULL, chd_decode_thread, chd_threads_file[i]) != 0)
+      {
+        chd_close(chd_threads_file[i]);
+        cdStreamClose(chd_threads_fd[i]);
+        break;
+      }
+    }
+
+#ifdef LOG_ERROR
+    if (i < chd_threads_count)
+    {
+      /* remaining hunks are decompressed by emulation thread */
+      error("CHD decoding threads: %d of %d started (%s)\n", i, chd_threads_count, image_filename);
+    }
 #endif
-  "%02d.wav",
-  " %02d.wav",
-  "-%02d.wav",
-  "_%02d.wav",
-  " - %02d.wav",
-  "%d.wav",
-  " %d.wav",
-  "-%d.wav",
-  "_%d.wav",
-  " - %d.wav"
-};
 
-#if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
+    chd_threads_num = i;
+    chd_threads_running = (i > 0);
+  }
+#endif
 
-static int seek64_wrap(void *f,ogg_int64_t off,int whence){
-  return cdStreamSeek(f,off,whence);
-}
+#ifdef USE_OGG_THREAD
+  if (!ogg_thread_running)
+  {
+    int i;
 
-static ov_callbacks cb =
-{ 
-  (size_t (*)(void *, size_t, size_t, void *))  cdStreamRead,
-  (int (*)(void *, ogg_int64_t, int))           seek64_wrap,
-  (int (*)(void *))                             cdStreamClose,
-  (long (*)(void *))                            cdStreamTell
-};
+    /* VORBIS decoding thread is only needed if VORBIS tracks are used */
+    for (i=0; i<cdd.toc.last; i++)
+    {
+      if (cdd.toc.tracks[i].vf.datasource)
+      {
+        ogg_ring.track = -1;
+        ogg_thread_running = 1;
+        if (pthread_create(&ogg_thread, NULL, ogg_decode_thread, NULL) != 0)
+        {
+          ogg_thread_running = 0;
+        }
+        break;
+      }
+    }
+  }
+#endif
+}
 
-#ifdef DISABLE_MANY_OGG_OPEN_FILES
-static void ogg_free(int i)
+void cdd_threads_stop(void)
 {
-  /* clear OGG file descriptor to prevent file from being closed */
-  cdd.toc.tracks[i].vf.datasource = NULL;
-
-  /* close VORBIS file structure */
-  ov_clear(&cdd.toc.tracks[i].vf);
+#if defined(USE_LIBCHDR) && defined(HAVE_THREADS)
+  if (chd_threads_running)
+  {
+    int i;
 
-  /* indicates that the track is a seekable VORBIS file */
-  cdd.toc.tracks[i].vf.seekable = 1;
+    CHD_LOCK();
+    chd_threads_running = 0;
+    pthread_cond_broadcast(&chd_wake);
+    CHD_UNLOCK();
 
-  /* reset file reading position */
-  cdStreamSeek(cdd.toc.tracks[i].fd, 0, SEEK_SET);
-}
+    for (i=0; i<chd_threads_num; i++)
+    {
+      pthread_join(chd_threads[i], NULL);
+      chd_close(chd_threads_file[i]);
+      cdStreamClose(chd_threads_fd[i]);
+    }
+  }
 #endif
 
+#ifdef USE_OGG_THREAD
+  if (ogg_thread_running)
+  {
+    pthread_mutex_lock(&ogg_lock);
+    ogg_thread_running = 0;
+    pthread_cond_signal(&ogg_wake);
+    pthread_mutex_unlock(&ogg_lock);
+    pthread_join(ogg_thread, NULL);
+
+    /* move VORBIS file to current playback position */
+    if (ogg_ring.track >= 0)
+    {
+      ov_pcm_seek(&cdd.toc.tracks[ogg_ring.track].vf, ogg_ring.read / 4);
+      ogg_ring.track = -1;
+    }
+  }
 #endif
+}
 
 void cdd_init(int samplerate)
 {
   /* CD-DA is running by default at 44100 Hz */
   /* Audio stream is resampled to desired rate using Blip Buffer */
   blip_set_rates(snd.blips[2], 44100, samplerate);
+
+  /* initialize subcode deinterleaving lookup table */
+  if (!lut_sub[0x80][0])
+  {
+    int i,j;
+    for (i=0; i<256; i++)
+    {
+      for (j=0; j<4; j++)
+      {
+        int bits = (i >> (6 - (j * 2))) & 3;
+        lut_sub[i][j] = ((bits & 1) << 7) | ((bits >> 1) << 15);
+      }
+    }
+  }
 }
 
 void cdd_reset(void)
@@ -289,9 +1647,12 @@ int cdd_context_load(uint8 *state)
   if (cdd.toc.sub)
   {
     /* 96 bytes per sector */
-    cdStreamSeek(cdd.toc.sub, lba * 96, SEEK_SET);
+    sub_seek(lba * 96);
   }
 
+  /* open current track file if needed */
+  track_open(cdd.index);
+
   /* seek to current track position */
 #if defined(USE_LIBCHDR)
   if (cdd.chd.file)
@@ -314,7 +1675,7 @@ int cdd_context_load(uint8 *state)
   if (cdd.toc.tracks[cdd.index].type)
   {
     /* DATA track */
-    cdStreamSeek(cdd.toc.tracks[cdd.index].fd, lba * cdd.sectorSize, SEEK_SET);
+    track_seek(cdd.index, lba * cdd.sectorSize);
   }
 #if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
   else if (cdd.toc.tracks[cdd.index].vf.seekable)
@@ -326,7 +1687,7 @@ int cdd_context_load(uint8 *state)
     ov_open_callbacks(cdd.toc.tracks[cdd.index].fd,&cdd.toc.tracks[cdd.index].vf,0,0,cb);
 #endif
     /* VORBIS AUDIO track */
-    ov_pcm_seek(&cdd.toc.tracks[cdd.index].vf, (lba * 588) - trackOffset + audioSampleDifference);
+    ogg_seek(cdd.index, (lba * 588) - trackOffset + audioSampleDifference);
   }
 #endif
   else if (cdd.toc.tracks[cdd.index].fd)
@@ -338,7 +1699,7 @@ int cdd_context_load(uint8 *state)
     int seekAddress;
     cdd.audioSampleOffset = cdd_get_audio_sample_offset_lba() + audioSampleDifference;
     seekAddress = trackStart * SECTOR_SIZE + cdd.audioSampleOffset * 4 - trackOffset;
-    cdStreamSeek(cdd.toc.tracks[cdd.index].fd, seekAddress, SEEK_SET);
+    track_seek(cdd.index, seekAddress);
   }
 
   return bufferptr;
@@ -354,9 +1715,17 @@ int cdd_load(char *filename, char *header)
   /* assume CD image file by default */
   int isCDfile = 1;
 
+  /* TOC loaded from index file */
+  int indexed = 0;
+
   /* first unmount any loaded disc */
   cdd_unload();
 
+  /* keep disc image filename (see cdd_reopen) */
+  file_name(&image_filename, filename);
+  if (!image_filename)
+    return (-1);
+
   /* open file */
   fd = cdStreamOpen(filename);
   if (!fd)
@@ -388,9 +1757,8 @@ int cdd_load(char *filename, char *header)
       return -1;
     }
 
-    /* allocate hunk buffer */
-    cdd.chd.hunk = (uint8 *)malloc(head->hunkbytes);
-    if (!cdd.chd.hunk)
+    /* allocate hunk cache */
+    if (!chd_cache_init(head->hunkbytes, head->totalhunks))
     {
       chd_close(cdd.chd.file);
       cdStreamClose(fd);
@@ -497,7 +1865,7 @@ int cdd_load(char *filename, char *header)
     {
       /* read first chunk of data */
       cdd.chd.hunknum = cdd.toc.tracks[0].offset / cdd.chd.hunkbytes;
-      chd_read(cdd.chd.file, cdd.chd.hunknum, cdd.chd.hunk);
+      cdd.chd.hunk = chd_cache_get(cdd.chd.hunknum);
 
       /* copy CD image header + security code (skip RAW sector 16-byte header) */
       memcpy(header, cdd.chd.hunk + (cdd.toc.tracks[0].offset % cdd.chd.hunkbytes) + ((cdd.sectorSize == 2048) ? 0 : 16), 0x210);
@@ -509,12 +1877,19 @@ int cdd_load(char *filename, char *header)
       /* Lead-out */
       cdd.toc.tracks[cdd.toc.last].start = cdd.toc.end;
 
+      /* start hunks decompression in background */
+      cdd_threads_start();
+
+      /* decompress whole image if requested */
+      chd_cache_preload();
+
       /* CD mounted */
       cdd.loaded = 1;
       return 1;
     }
 
     /* invalid CHD file */
+    chd_cache_free();
     chd_close(cdd.chd.file);
     cdStreamClose(fd);
     return -1;
@@ -524,8 +1899,25 @@ int cdd_load(char *filename, char *header)
   /* save a copy of base filename */
   strncpy(fname, filename, 256);
 
+  /* try to load TOC from index file first (disc image files are not parsed) */
+  if (index_enabled)
+  {
+    int result = cdd_index_load(header, fname);
+    if (result >= 0)
+    {
+      isCDfile = result;
+      indexed = 1;
+      cdStreamClose(fd);
+      fd = 0;
+    }
+  }
+
   /* check loaded file extension */
-  if (memcmp("cue", &filename[strlen(filename) - 3], 3) && memcmp("CUE", &filename[strlen(filename) - 3], 3))
+  if (indexed)
+  {
+    /* TOC already initialized */
+  }
+  else if (memcmp("cue", &filename[strlen(filename) - 3], 3) && memcmp("CUE", &filename[strlen(filename) - 3], 3))
   {
     int len;
 
@@ -565,6 +1957,8 @@ int cdd_load(char *filename, char *header)
 
       /* initialize first track file descriptor */
       cdd.toc.tracks[0].fd = fd;
+      track_map(0, filename);
+      track_name(0, filename);
 
       /* DATA track end LBA (based on DATA file length) */
       cdStreamSeek(fd, 0, SEEK_END);
@@ -669,6 +2063,7 @@ int cdd_load(char *filename, char *header)
           /* error opening file */
           break;
         }
+        track_name(cdd.toc.last, fname);
 
         /* reset current file PREGAP length */
         pregap = 0;
@@ -736,6 +2131,14 @@ int cdd_load(char *filename, char *header)
             break;
           }
         }
+
+#if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
+        if (!cdd.toc.tracks[cdd.toc.last].vf.datasource)
+#endif
+        {
+          /* map BINARY or WAVE file */
+          track_map(cdd.toc.last, fname);
+        }
       }
 
       /* decode TRACK commands */
@@ -816,6 +2219,9 @@ int cdd_load(char *filename, char *header)
         {
           /* use common file descriptor */
           cdd.toc.tracks[cdd.toc.last].fd = cdd.toc.tracks[cdd.toc.last - 1].fd;
+          cdd.toc.tracks[cdd.toc.last].map = cdd.toc.tracks[cdd.toc.last - 1].map;
+          cdd.toc.tracks[cdd.toc.last].mapsize = cdd.toc.tracks[cdd.toc.last - 1].mapsize;
+          track_name(cdd.toc.last, track_names[cdd.toc.last - 1]);
 
           /* current track start time (based on current file absolute time + PREGAP length) */
           cdd.toc.tracks[cdd.toc.last].start = bb + ss*75 + mm*60*75 + pregap;
@@ -918,7 +2324,7 @@ int cdd_load(char *filename, char *header)
     /* close CUE file */
     cdStreamClose(fd);
   }
-  else if (cdd.toc.last)
+  else if (cdd.toc.last && !indexed)
   {
     int i, offset = 1;
 
@@ -978,6 +2384,8 @@ int cdd_load(char *filename, char *header)
 
         /* initialize current track file descriptor */
         cdd.toc.tracks[cdd.toc.last].fd = fd;
+        track_map(cdd.toc.last, fname);
+        track_name(cdd.toc.last, fname);
 
         /* initialize current track start time (based on previous track end time) */
         cdd.toc.tracks[cdd.toc.last].start = cdd.toc.end;
@@ -1026,6 +2434,7 @@ int cdd_load(char *filename, char *header)
 
         /* initialize current track file descriptor */
         cdd.toc.tracks[cdd.toc.last].fd = fd;
+        track_name(cdd.toc.last, fname);
 
         /* initialize current track start time (based on previous track end time) */
         cdd.toc.tracks[cdd.toc.last].start = cdd.toc.end;
@@ -1209,6 +2618,22 @@ int cdd_load(char *filename, char *header)
     /* Automatically try to open associated subcode data file */
     memcpy(&fname[strlen(fname) - 4], ".sub", 4);
     cdd.toc.sub = cdStreamOpen(fname);
+    file_name(&sub_filename, cdd.toc.sub ? fname : NULL);
+
+    /* save parsed TOC for next time */
+    if (index_enabled && !indexed)
+    {
+      cdd_index_save(fname, isCDfile);
+    }
+
+    /* load whole disc image in memory if requested */
+    if (preload_size)
+    {
+      cdd_preload();
+    }
+
+    /* start VORBIS tracks decoding in background */
+    cdd_threads_start();
 
     /* return 1 if loaded file is CD image file */
     return (isCDfile);
@@ -1218,16 +2643,127 @@ int cdd_load(char *filename, char *header)
   return 0;
 }
 
+int cdd_reopen(void)
+{
+  if (cdd.loaded)
+  {
+    /* only file handles are reopened, parsed TOC, preloaded data, decoded CHD hunks & mapped files are kept */
+    /* inherited handles are not closed since this could move file offsets still used by parent process   */
+    int i, j;
+    uint8 state[32];
+    cdStream *fd, *old;
+
+    /* current position (VORBIS files are still opened) */
+    cdd_context_save(state);
+
+#if defined(USE_LIBCHDR)
+    if (cdd.chd.file)
+    {
+      /* CHD file (shared by all tracks) */
+      chd_file *file = NULL;
+      old = cdd.toc.tracks[0].fd;
+      fd = cdStreamOpen(image_filename);
+      if (!fd)
+        return 0;
+      if (chd_open_file(fd, CHD_OPEN_READ, NULL, &file) != CHDERR_NONE)
+      {
+        cdStreamClose(fd);
+        return 0;
+      }
+      chd_close(cdd.chd.file);
+      cdd.chd.file = file;
+      for (i=0; i<cdd.toc.last; i++)
+      {
+        if (cdd.toc.tracks[i].fd == old)
+          cdd.toc.tracks[i].fd = fd;
+      }
+    }
+    else
+#endif
+    for (i=0; i<cdd.toc.last; i++)
+    {
+      /* skip tracks without file, read from memory or sharing file with a previous track */
+      old = cdd.toc.tracks[i].fd;
+      for (j=0; (j<i) && (cdd.toc.tracks[j].fd != old); j++);
+      if (!old || (j < i) || cdd.toc.tracks[i].map)
+        continue;
+
+      fd = track_names[i] ? cdStreamOpen(track_names[i]) : NULL;
+      if (!fd)
+        return 0;
+
+#if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
+      if (cdd.toc.tracks[i].vf.datasource)
+      {
+        /* reopen VORBIS file structure */
+        cdd.toc.tracks[i].vf.datasource = NULL;
+        ov_clear(&cdd.toc.tracks[i].vf);
+#ifdef DISABLE_MANY_OGG_OPEN_FILES
+        /* current track VORBIS file structure is opened when position is restored */
+        cdd.toc.tracks[i].vf.seekable = 1;
+#else
+        if (ov_open_callbacks(fd,&cdd.toc.tracks[i].vf,0,0,cb))
+        {
+          cdStreamClose(fd);
+          return 0;
+        }
+#endif
+      }
+#endif
+
+      /* update tracks sharing the same file */
+      for (j=i; j<cdd.toc.last; j++)
+      {
+        if (cdd.toc.tracks[j].fd == old)
+          cdd.toc.tracks[j].fd = fd;
+      }
+    }
+
+    /* subcode file (unless preloaded) */
+    if (cdd.toc.sub && !preload.sub)
+    {
+      fd = sub_filename ? cdStreamOpen(sub_filename) : NULL;
+      if (!fd)
+        return 0;
+      cdd.toc.sub = fd;
+    }
+
+    /* restart background threads & restore current position */
+    cdd_threads_start();
+    cdd_context_load(state);
+  }
+
+  return 1;
+}
+
 void cdd_unload(void)
 {
   if (cdd.loaded)
   {
     int i;
 
+#if defined(HAVE_MMAP)
+    /* unmap track files (single file may be used for several tracks) */
+    for (i=0; (i<cdd.toc.last) && !preload.data; i++)
+    {
+      if (cdd.toc.tracks[i].map)
+      {
+        int j = 0;
+        while ((j < i) && (cdd.toc.tracks[j].map != cdd.toc.tracks[i].map)) j++;
+        if (j == i)
+        {
+          munmap(cdd.toc.tracks[i].map, cdd.toc.tracks[i].mapsize);
+        }
+      }
+    }
+#endif
+
+    /* stop background threads */
+    cdd_threads_stop();
+
 #if defined(USE_LIBCHDR)
+    chd_cache_free();
     chd_close(cdd.chd.file);
-    if (cdd.chd.hunk)
-      free(cdd.chd.hunk);
 #endif
 
     /* close CD tracks */
@@ -1243,13 +2779,10 @@ void cdd_unload(void)
 #endif
       if (cdd.toc.tracks[i].fd)
       {
-        /* check if single file is used for consecutive tracks */
-        if ((i > 0) && (cdd.toc.tracks[i].fd == cdd.toc.tracks[i-1].fd))
-        {
-          /* skip track */
-          i++;
-        }
-        else
+        /* check if single file is used for several tracks */
+        int j = 0;
+        while ((j < i) && (cdd.toc.tracks[j].fd != cdd.toc.tracks[i].fd)) j++;
+        if (j == i)
         {
           /* close file */
           cdStreamClose(cdd.toc.tracks[i].fd);
@@ -1260,13 +2793,43 @@ void cdd_unload(void)
     /* close any opened subcode file */
     if (cdd.toc.sub)
       cdStreamClose(cdd.toc.sub);
+    file_name(&sub_filename, NULL);
+
+    /* release preloaded disc image */
+    free(preload.data);
+    memset(&preload, 0, sizeof(preload));
+
+    /* invalidate decoded subcode data */
+    memset(&sub_cache, 0, sizeof(sub_cache));
 
     /* CD unloaded */
     cdd.loaded = 0;
   }
 
-  /* reset TOC */
-  memset(&cdd.toc, 0x00, sizeof(cdd.toc));
+  /* reset TOC (only if modified, so that CD hardware memory pages are not needlessly used when running cartridges) */
+  {
+    const uint8 *ptr = (const uint8 *)&cdd.toc;
+    int size = sizeof(cdd.toc);
+    while (size && !*ptr)
+    {
+      ptr++;
+      size--;
+    }
+    if (size)
+    {
+      memset(&cdd.toc, 0x00, sizeof(cdd.toc));
+    }
+  }
+
+  /* reset track files infos */
+  {
+    int i;
+    for (i=0; i<100; i++)
+    {
+      track_name(i, NULL);
+    }
+    memset(track_kind, 0, sizeof(track_kind));
+  }
 
 #if defined(USE_LIBCHDR)
   /* reset CHD data */
@@ -1294,7 +2857,7 @@ void cdd_read_data(uint8 *dst, uint8 *subheader)
       /* update CHD hunk cache if necessary */
       if (hunknum != cdd.chd.hunknum)
       {
-        chd_read(cdd.chd.file, hunknum, cdd.chd.hunk);
+        cdd.chd.hunk = chd_cache_get(hunknum);
         cdd.chd.hunknum = hunknum;
       }
 
@@ -1330,8 +2893,8 @@ void cdd_read_data(uint8 *dst, uint8 *subheader)
     if (cdd.sectorSize == 2048)
     {
       /* read Mode 1 user data (2048 bytes) */
-      cdStreamSeek(cdd.toc.tracks[0].fd, cdd.lba * 2048, SEEK_SET);
-      cdStreamRead(dst, 2048, 1, cdd.toc.tracks[0].fd);
+      track_seek(0, cdd.lba * 2048);
+      track_read(0, dst, 2048);
     }
     else
     {
@@ -1339,17 +2902,17 @@ void cdd_read_data(uint8 *dst, uint8 *subheader)
       if (!subheader)
       {
         /* skip block sync pattern (12 bytes) + block header (4 bytes) then read Mode 1 user data (2048 bytes) */
-        cdStreamSeek(cdd.toc.tracks[0].fd, (cdd.lba * 2352) + 12 + 4, SEEK_SET);
-        cdStreamRead(dst, 2048, 1, cdd.toc.tracks[0].fd);
+        track_seek(0, (cdd.lba * 2352) + 12 + 4);
+        track_read(0, dst, 2048);
       }
       else
       {
         /* skip block sync pattern (12 bytes) + block header (4 bytes) + Mode 2 sub-header (first 4 bytes) then read Mode 2 sub-header (last 4 bytes) */
-        cdStreamSeek(cdd.toc.tracks[0].fd, (cdd.lba * 2352) + 12 + 4 + 4, SEEK_SET);
-        cdStreamRead(subheader, 4, 1, cdd.toc.tracks[0].fd);
+        track_seek(0, (cdd.lba * 2352) + 12 + 4 + 4);
+        track_read(0, subheader, 4);
 
         /* read Mode 2 user data (max 2328 bytes) */
-        cdStreamRead(dst, 2328, 1, cdd.toc.tracks[0].fd);
+        track_read(0, dst, 2328);
       }
     }
   }
@@ -1428,8 +2991,15 @@ void cdd_read_audio(unsigned int samples)
         /* update CHD hunk cache if necessary */
         if (hunknum != cdd.chd.hunknum)
         {
-          chd_read(cdd.chd.file, hunknum, cdd.chd.hunk);
+          cdd.chd.hunk = chd_cache_get(hunknum);
           cdd.chd.hunknum = hunknum;
+
+          /* reinitialize hunk cache pointer */
+#ifndef LSB_FIRST
+          ptr = (int16 *) (cdd.chd.hunk + (cdd.chd.hunkofs % cdd.chd.hunkbytes));
+#else
+          ptr = cdd.chd.hunk + (cdd.chd.hunkofs % cdd.chd.hunkbytes);
+#endif
         }
 
         /* CD-DA fader multiplier (cf. LC7883 datasheet) */
@@ -1495,11 +3065,7 @@ void cdd_read_audio(unsigned int samples)
       samples = samples * 4;
       while (done < samples)
       {
-#ifdef USE_LIBVORBIS
-        len = ov_read(&cdd.toc.tracks[cdd.index].vf, (char *)(cdc.ram + done), samples - done, 0, 2, 1, 0);
-#else
-        len = ov_read(&cdd.toc.tracks[cdd.index].vf, (char *)(cdc.ram + done), samples - done, 0);
-#endif
+        len = ogg_read(cdd.index, cdc.ram + done, samples - done);
         if (len <= 0) 
         {
           done = samples;
@@ -1545,12 +3111,29 @@ void cdd_read_audio(unsigned int samples)
     else
 #endif
     {
+      /* use mapped file data directly if available */
+      uint8 *data = track_data(cdd.index, samples * 4);
 #ifdef LSB_FIRST
-      int16 *ptr = (int16 *) (cdc.ram);
+      int16 *ptr;
+#else
+      uint8 *ptr;
+#endif
+      if (!data)
+      {
+        track_read(cdd.index, cdc.ram, samples * 4);
+        data = cdc.ram;
+      }
+#ifdef LSB_FIRST
+      else if ((size_t)data & 1)
+      {
+        /* unaligned 16-bit samples */
+        memcpy(cdc.ram, data, samples * 4);
+        data = cdc.ram;
+      }
+      ptr = (int16 *) data;
 #else
-      uint8 *ptr = cdc.ram;
+      ptr = data;
 #endif
-      cdStreamRead(cdc.ram, 1, samples * 4, cdd.toc.tracks[cdd.index].fd);
 
       /* process 16-bit (little-endian) stereo samples */
       for (i=0; i<samples; i++)
@@ -1618,8 +3201,8 @@ void cdd_read_audio(unsigned int samples)
 
 static void cdd_read_subcode(void)
 {
-  uint8 subc[96];
-  int i,j,index;
+  const uint16 *code;
+  int i,index;
 
   /* update subcode buffer pointer address */
   scd.regs[0x68>>1].byte.l = (scd.regs[0x68>>1].byte.l + 98) & 0x7e;
@@ -1627,22 +3210,13 @@ static void cdd_read_subcode(void)
   /* 16-bit register index */
   index = (scd.regs[0x68>>1].byte.l + 0x100) >> 1;
 
-  /* read interleaved subcode data from .sub file (12 x 8-bit of P subchannel first, then Q subchannel, etc) */
-  cdStreamRead(subc, 1, 96, cdd.toc.sub);
+  /* get decoded subcode data from .sub file */
+  code = sub_read();
 
-  /* convert back to raw subcode format (96 bytes with 8 x P-W subchannel bits per byte) */
-  for (i=0; i<96; i+=2)
+  for (i=0; i<48; i++)
   {
-    int code = 0;
-    for (j=0; j<8; j++)
-    {
-      int bits = (subc[(j*12)+(i/8)] >> (6 - (i & 6))) & 3;
-      code |= ((bits & 1) << (7 - j));
-      code |= ((bits >> 1) << (15 - j));
-    }
-
     /* subcode buffer is accessed as 16-bit words */
-    scd.regs[index].w = code;
+    scd.regs[index].w = code[i];
 
     /* subcode buffer is limited to 64 x 16-bit words */
     index = (index + 1) & 0xbf;
@@ -1732,6 +3306,7 @@ void cdd_update(void)
 #endif
       /* play next track */
       cdd.index++;
+      track_open(cdd.index);
 
       /* PAUSE between tracks */
       scd.regs[0x36>>1].byte.h = 0x01;
@@ -1753,14 +3328,14 @@ void cdd_update(void)
         /* VORBIS file need to be opened first */
         ov_open_callbacks(cdd.toc.tracks[cdd.index].fd,&cdd.toc.tracks[cdd.index].vf,0,0,cb);
 #endif
-        ov_pcm_seek(&cdd.toc.tracks[cdd.index].vf, (cdd.toc.tracks[cdd.index].start * 588) - cdd.toc.tracks[cdd.index].offset);
+        ogg_seek(cdd.index, (cdd.toc.tracks[cdd.index].start * 588) - cdd.toc.tracks[cdd.index].offset);
         cdd.audioSampleOffset = 0;
       }
       else
 #endif 
       if (cdd.toc.tracks[cdd.index].fd)
       {
-        cdStreamSeek(cdd.toc.tracks[cdd.index].fd, (cdd.toc.tracks[cdd.index].start * 2352) - cdd.toc.tracks[cdd.index].offset, SEEK_SET);
+        track_seek(cdd.index, (cdd.toc.tracks[cdd.index].start * 2352) - cdd.toc.tracks[cdd.index].offset);
         cdd.audioSampleOffset = 0;
       }
     }
@@ -1833,13 +3408,16 @@ void cdd_update(void)
       }
     }
 
+    /* open current track file if needed */
+    track_open(cdd.index);
+
     /* AUDIO track playing ? */
     scd.regs[0x36>>1].byte.h = cdd.toc.tracks[cdd.index].type ? 0x01 : 0x00;
 
     /* seek to current subcode position */
     if (cdd.toc.sub)
     {
-      cdStreamSeek(cdd.toc.sub, cdd.lba * 96, SEEK_SET);
+      sub_seek(cdd.lba * 96);
     }
 
     /* seek to current track position */
@@ -1855,7 +3433,7 @@ void cdd_update(void)
     if (cdd.toc.tracks[cdd.index].type)
     {
       /* DATA track */
-      cdStreamSeek(cdd.toc.tracks[0].fd, cdd.lba * cdd.sectorSize, SEEK_SET);
+      track_seek(0, cdd.lba * cdd.sectorSize);
     }
 #if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
     else if (cdd.toc.tracks[cdd.index].vf.seekable)
@@ -1869,19 +3447,28 @@ void cdd_update(void)
       }
 #endif
       /* VORBIS AUDIO track */
-      ov_pcm_seek(&cdd.toc.tracks[cdd.index].vf, (cdd.lba * 588) - cdd.toc.tracks[cdd.index].offset);
+      ogg_seek(cdd.index, (cdd.lba * 588) - cdd.toc.tracks[cdd.index].offset);
       cdd.audioSampleOffset = cdd_get_audio_sample_offset_lba();
     }
 #endif 
     else if (cdd.toc.tracks[cdd.index].fd)
     {
       /* PCM AUDIO track */
-      cdStreamSeek(cdd.toc.tracks[cdd.index].fd, (cdd.lba * 2352) - cdd.toc.tracks[cdd.index].offset, SEEK_SET);
+      track_seek(cdd.index, (cdd.lba * 2352) - cdd.toc.tracks[cdd.index].offset);
       cdd.audioSampleOffset = cdd_get_audio_sample_offset_lba();
     }
   }
 }
 
+void cdd_fast_update(void)
+{
+  /* fast CD access: read next CD-ROM track sector as soon as previous one has been processed by CDC */
+  if ((cdd.status == CD_PLAY) && !cdd.latency && (cdd.index < cdd.toc.last) && cdd.toc.tracks[cdd.index].type && cdc_decoder_ready())
+  {
+    cdd_update();
+  }
+}
+
 void cdd_process(void)
 {
   /* Process CDD command */
@@ -2071,13 +3658,17 @@ void cdd_process(void)
       /* Note: This is only a rough approximation since, on real hardware, seek time is much likely not linear and */
       /* latency much larger than above value, but this model works fine for Sonic CD (track 26 playback needs to  */
       /* be enough delayed to start in sync with intro sequence, as compared with real hardware recording).        */
-      if (lba > cdd.lba)
-      {
-        cdd.latency += (((lba - cdd.lba) * 120) / 270000);
-      }
-      else 
+      /* With fast CD access, seek time is ignored (initial latency is still needed by some games, see above).     */
+      if (config.cd_speed <= 1)
       {
-        cdd.latency += (((cdd.lba - lba) * 120) / 270000);
+        if (lba > cdd.lba)
+        {
+          cdd.latency += (((lba - cdd.lba) * 120) / 270000);
+        }
+        else 
+        {
+          cdd.latency += (((cdd.lba - lba) * 120) / 270000);
+        }
       }
 
       /* update current LBA */
@@ -2086,6 +3677,9 @@ void cdd_process(void)
       /* get track index */
       while ((cdd.toc.tracks[index].end <= lba) && (index < cdd.toc.last)) index++;
 
+      /* open track file if needed */
+      track_open(index);
+
 #if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
 #ifdef DISABLE_MANY_OGG_OPEN_FILES
       /* check if track index has changed */
@@ -2127,27 +3721,27 @@ void cdd_process(void)
       if (cdd.toc.tracks[index].type)
       {
         /* DATA track */
-        cdStreamSeek(cdd.toc.tracks[index].fd, lba * cdd.sectorSize, SEEK_SET);
+        track_seek(index, lba * cdd.sectorSize);
       }
 #if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
       else if (cdd.toc.tracks[index].vf.seekable)
       {
         /* VORBIS AUDIO track */
-        ov_pcm_seek(&cdd.toc.tracks[index].vf, (lba * 588) - cdd.toc.tracks[index].offset);
+        ogg_seek(index, (lba * 588) - cdd.toc.tracks[index].offset);
         cdd.audioSampleOffset = cdd_get_audio_sample_offset_lba();
       }
 #endif 
       else if (cdd.toc.tracks[index].fd)
       {
         /* PCM AUDIO track */
-        cdStreamSeek(cdd.toc.tracks[index].fd, (lba * 2352) - cdd.toc.tracks[index].offset, SEEK_SET);
+        track_seek(index, (lba * 2352) - cdd.toc.tracks[index].offset);
         cdd.audioSampleOffset = cdd_get_audio_sample_offset_lba();
       }
 
       /* seek to current subcode position */
       if (cdd.toc.sub)
       {
-        cdStreamSeek(cdd.toc.sub, lba * 96, SEEK_SET);
+        sub_seek(lba * 96);
       }
 
       /* no audio track playing (yet) */
@@ -2180,7 +3774,12 @@ void cdd_process(void)
       /* We are using similar linear model as above, although still not exactly accurate, */
       /* it works fine for Switch/Panic! intro (Switch needs at least 30 interrupts while */
       /* seeking from 00:05:63 to 24:03:19, Panic! when seeking from 00:05:60 to 24:06:07) */
-      if (lba > cdd.lba)
+      /* With fast CD access, seeking completes within one CDD interrupt.                   */
+      if (config.cd_speed > 1)
+      {
+        cdd.latency = 0;
+      }
+      else if (lba > cdd.lba)
       {
         cdd.latency = ((lba - cdd.lba) * 120) / 270000;
       }
@@ -2195,6 +3794,9 @@ void cdd_process(void)
       /* get current track index */
       while ((cdd.toc.tracks[index].end <= lba) && (index < cdd.toc.last)) index++;
 
+      /* open track file if needed */
+      track_open(index);
+
 #if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
 #ifdef DISABLE_MANY_OGG_OPEN_FILES
       /* check if track index has changed */
@@ -2236,27 +3838,27 @@ void cdd_process(void)
       if (cdd.toc.tracks[index].type)
       {
         /* DATA track */
-        cdStreamSeek(cdd.toc.tracks[index].fd, lba * cdd.sectorSize, SEEK_SET);
+        track_seek(index, lba * cdd.sectorSize);
       }
 #if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
       else if (cdd.toc.tracks[index].vf.seekable)
       {
         /* VORBIS AUDIO track */
-        ov_pcm_seek(&cdd.toc.tracks[index].vf, (lba * 588) - cdd.toc.tracks[index].offset);
+        ogg_seek(index, (lba * 588) - cdd.toc.tracks[index].offset);
         cdd.audioSampleOffset = cdd_get_audio_sample_offset_lba();
       }
 #endif 
       else if (cdd.toc.tracks[index].fd)
       {
         /* PCM AUDIO track */
-        cdStreamSeek(cdd.toc.tracks[index].fd, (lba * 2352) - cdd.toc.tracks[index].offset, SEEK_SET);
+        track_seek(index, (lba * 2352) - cdd.toc.tracks[index].offset);
         cdd.audioSampleOffset = cdd_get_audio_sample_offset_lba();
       }
 
       /* seek to current subcode position */
       if (cdd.toc.sub)
       {
-        cdStreamSeek(cdd.toc.sub, lba * 96, SEEK_SET);
+        sub_seek(lba * 96);
       }
 
       /* no audio track playing */
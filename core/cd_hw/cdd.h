@@ -82,6 +82,9 @@ typedef struct
 #if defined(USE_LIBTREMOR) || defined(USE_LIBVORBIS)
   OggVorbis_File vf;
 #endif
+  uint8 *map;     /* track file data in memory (mapped or preloaded) */
+  int mapsize;
+  int mappos;
   int offset;
   int start;
   int end;
@@ -136,10 +139,17 @@ extern void cdd_reset(void);
 extern int cdd_context_save(uint8 *state);
 extern int cdd_context_load(uint8 *state);
 extern int cdd_load(char *filename, char *header);
+extern int cdd_reopen(void);
+extern void cdd_set_chd_cache(int hunks, int threads);
+extern void cdd_set_index(int enable);
+extern void cdd_set_preload(int megabytes);
+extern void cdd_threads_start(void);
+extern void cdd_threads_stop(void);
 extern void cdd_unload(void);
 extern void cdd_read_data(uint8 *dst, uint8 *subheader);
 extern void cdd_read_audio(unsigned int samples);
 extern void cdd_update(void);
+extern void cdd_fast_update(void);
 extern void cdd_process(void);
 
 #endif
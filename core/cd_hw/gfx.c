@@ -43,8 +43,6 @@
 
 void word_ram_0_dma_w(unsigned int words)
 {
-  uint16 data;
-
   /* CDC buffer source address */
   uint16 src_index = cdc.dac.w & 0x3ffe;
 
@@ -57,27 +55,12 @@ void word_ram_0_dma_w(unsigned int words)
   /* update DMA source address */
   cdc.dac.w += (words << 1);
 
-  /* DMA transfer */
-  while (words--)
-  {
-    /* read 16-bit word from CDC RAM buffer (big-endian format) */
-    data = READ_WORD(cdc.ram, src_index);
-
-    /* write 16-bit word to WORD-RAM */
-    *(uint16 *)(scd.word_ram[0] + dst_index) = data ;
-
-    /* increment CDC buffer source address */
-    src_index = (src_index + 2) & 0x3ffe;
-
-    /* increment WORD-RAM destination address */
-    dst_index = (dst_index + 2) & 0x1fffe;
-  }
+  /* DMA transfer (16-bit words are read from CDC RAM buffer in big-endian format) */
+  cdc_dma_copy(scd.word_ram[0], dst_index, 0x1fffe, src_index, words, 1);
 }
 
 void word_ram_1_dma_w(unsigned int words)
 {
-  uint16 data;
-
   /* CDC buffer source address */
   uint16 src_index = cdc.dac.w & 0x3ffe;
 
@@ -90,27 +73,12 @@ void word_ram_1_dma_w(unsigned int words)
   /* update DMA source address */
   cdc.dac.w += (words << 1);
 
-  /* DMA transfer */
-  while (words--)
-  {
-    /* read 16-bit word from CDC RAM buffer (big-endian format) */
-    data = READ_WORD(cdc.ram, src_index);
-
-    /* write 16-bit word to WORD-RAM */
-    *(uint16 *)(scd.word_ram[1] + dst_index) = data ;
-
-    /* increment CDC buffer source address */
-    src_index = (src_index + 2) & 0x3ffe;
-
-    /* increment WORD-RAM destination address */
-    dst_index = (dst_index + 2) & 0x1fffe;
-  }
+  /* DMA transfer (16-bit words are read from CDC RAM buffer in big-endian format) */
+  cdc_dma_copy(scd.word_ram[1], dst_index, 0x1fffe, src_index, words, 1);
 }
 
 void word_ram_2M_dma_w(unsigned int words)
 {
-  uint16 data;
-
   /* CDC buffer source address */
   uint16 src_index = cdc.dac.w & 0x3ffe;
 
@@ -123,21 +91,8 @@ void word_ram_2M_dma_w(unsigned int words)
   /* update DMA source address */
   cdc.dac.w += (words << 1);
 
-  /* DMA transfer */
-  while (words--)
-  {
-    /* read 16-bit word from CDC RAM buffer (big-endian format) */
-    data = READ_WORD(cdc.ram, src_index);
-
-    /* write 16-bit word to WORD-RAM */
-    *(uint16 *)(scd.word_ram_2M + dst_index) = data ;
-
-    /* increment CDC buffer source address */
-    src_index = (src_index + 2) & 0x3ffe;
-
-    /* increment WORD-RAM destination address */
-    dst_index = (dst_index + 2) & 0x3fffe;
-  }
+  /* DMA transfer (16-bit words are read from CDC RAM buffer in big-endian format) */
+  cdc_dma_copy(scd.word_ram_2M, dst_index, 0x3fffe, src_index, words, 1);
 }
 
 
@@ -581,6 +536,145 @@ INLINE void gfx_render(uint32 bufferIndex, uint32 width)
   }
 }
 
+/* Specialized rendering (stamp & map size, repeat and priority modes are constant within a line) */
+INLINE uint32 gfx_stamp_index(uint32 xpos, uint32 ypos, const int size, const int repeat)
+{
+  /* stamp map size mask, stamp pixel shift and stamp map table shift values (see gfx_start) */
+  const uint32 dotMask = (size & 2) ? 0x7fffff : 0x07ffff;
+  const int stampShift = 11 + 4 + (size & 1);
+  const int mapShift = ((size & 2) ? 8 : 4) - (size & 1);
+
+  uint32 stamp_data, stamp_index;
+
+  /* check if pixel is outside stamp map (24-bit range) */
+  if (!repeat && ((xpos | ypos) & 0xffffff & ~dotMask))
+  {
+    return 0;
+  }
+
+  /* stamp map range */
+  xpos &= dotMask;
+  ypos &= dotMask;
+
+  /* read stamp map table data */
+  stamp_data = gfx.mapPtr[(xpos >> stampShift) | ((ypos >> stampShift) << mapShift)];
+
+  /* stamp 0 is not used */
+  stamp_index = (stamp_data & 0x7ff) << 8;
+  if (!stamp_index)
+  {
+    return 0;
+  }
+
+  /* extract HFLIP & ROTATION bits */
+  stamp_data = (stamp_data >> 13) & 7;
+
+  /* cell & pixel offsets (see gfx_render) */
+  stamp_index |= gfx.lut_cell[stamp_data | ((size & 1) << 3) | ((ypos >> 8) & 0xc0) | ((xpos >> 10) & 0x30)] << 6;
+  return stamp_index | gfx.lut_pixel[stamp_data | ((xpos >> 8) & 0x38) | ((ypos >> 5) & 0x1c0)];
+}
+
+INLINE uint8 gfx_stamp_pixel(uint32 stamp_index)
+{
+  /* read left or right pixel (0 if stamp is not used or pixel is outside stamp map) */
+  uint8 pixel = READ_BYTE(scd.word_ram_2M, stamp_index >> 1);
+  return (stamp_index & 1) ? (pixel & 0x0f) : (pixel >> 4);
+}
+
+INLINE uint8 gfx_write_pixel(uint8 pixel_in, uint8 pixel_out, const int prio)
+{
+  /* priority mode write (normal mode always overwrites) */
+  return prio ? gfx.lut_prio[prio][pixel_in][pixel_out] : pixel_out;
+}
+
+INLINE void gfx_render_line(uint32 bufferIndex, uint32 width, const int size, const int repeat, const int prio)
+{
+  uint8 pixel_in, pixel_out;
+  uint32 stamp_index;
+
+  /* pixel map start position and offset values for current line (see gfx_render) */
+  uint32 xpos = *gfx.tracePtr++ << 8;
+  uint32 ypos = *gfx.tracePtr++ << 8;
+  uint32 xoffset = (int16) *gfx.tracePtr++;
+  uint32 yoffset = (int16) *gfx.tracePtr++;
+
+  /* right pixel of first byte */
+  if ((bufferIndex & 1) && width)
+  {
+    stamp_index = gfx_stamp_index(xpos, ypos, size, repeat);
+    pixel_out = stamp_index ? gfx_stamp_pixel(stamp_index) : 0;
+    pixel_in = READ_BYTE(scd.word_ram_2M, bufferIndex >> 1);
+    WRITE_BYTE(scd.word_ram_2M, bufferIndex >> 1, gfx_write_pixel(pixel_in, pixel_out | (pixel_in & 0xf0), prio));
+    bufferIndex = ((bufferIndex & 7) != 7) ? (bufferIndex + 1) : (bufferIndex + gfx.bufferOffset);
+    xpos += xoffset;
+    ypos += yoffset;
+    width--;
+  }
+
+  /* process pixel pairs (one image buffer byte at a time) */
+  while (width >= 2)
+  {
+    /* left pixel */
+    stamp_index = gfx_stamp_index(xpos, ypos, size, repeat);
+    pixel_out = stamp_index ? gfx_stamp_pixel(stamp_index) : 0;
+    pixel_in = READ_BYTE(scd.word_ram_2M, bufferIndex >> 1);
+    pixel_in = gfx_write_pixel(pixel_in, (pixel_out << 4) | (pixel_in & 0x0f), prio);
+
+    /* written back first as image buffer could overlap stamp data or stamp map table */
+    WRITE_BYTE(scd.word_ram_2M, bufferIndex >> 1, pixel_in);
+
+    /* right pixel */
+    stamp_index = gfx_stamp_index(xpos + xoffset, ypos + yoffset, size, repeat);
+    pixel_out = stamp_index ? gfx_stamp_pixel(stamp_index) : 0;
+    WRITE_BYTE(scd.word_ram_2M, bufferIndex >> 1, gfx_write_pixel(pixel_in, pixel_out | (pixel_in & 0xf0), prio));
+
+    /* next cell: increment image buffer offset by one column (minus 7 pixels) */
+    bufferIndex = ((bufferIndex & 7) != 6) ? (bufferIndex + 2) : (bufferIndex + 1 + gfx.bufferOffset);
+    xpos += xoffset * 2;
+    ypos += yoffset * 2;
+    width -= 2;
+  }
+
+  /* left pixel of last byte */
+  if (width)
+  {
+    stamp_index = gfx_stamp_index(xpos, ypos, size, repeat);
+    pixel_out = stamp_index ? gfx_stamp_pixel(stamp_index) : 0;
+    pixel_in = READ_BYTE(scd.word_ram_2M, bufferIndex >> 1);
+    WRITE_BYTE(scd.word_ram_2M, bufferIndex >> 1, gfx_write_pixel(pixel_in, (pixel_out << 4) | (pixel_in & 0x0f), prio));
+  }
+}
+
+static void gfx_render_none(uint32 bufferIndex, uint32 width)
+{
+  /* invalid priority mode: image buffer is not modified */
+  gfx.tracePtr += 4;
+}
+
+#define GFX_RENDER_MODE(size, repeat, prio) \
+static void gfx_render_##size##repeat##prio(uint32 bufferIndex, uint32 width) \
+{ \
+  gfx_render_line(bufferIndex, width, size, repeat, prio); \
+}
+
+GFX_RENDER_MODE(0,0,0) GFX_RENDER_MODE(0,0,1) GFX_RENDER_MODE(0,0,2)
+GFX_RENDER_MODE(0,1,0) GFX_RENDER_MODE(0,1,1) GFX_RENDER_MODE(0,1,2)
+GFX_RENDER_MODE(1,0,0) GFX_RENDER_MODE(1,0,1) GFX_RENDER_MODE(1,0,2)
+GFX_RENDER_MODE(1,1,0) GFX_RENDER_MODE(1,1,1) GFX_RENDER_MODE(1,1,2)
+GFX_RENDER_MODE(2,0,0) GFX_RENDER_MODE(2,0,1) GFX_RENDER_MODE(2,0,2)
+GFX_RENDER_MODE(2,1,0) GFX_RENDER_MODE(2,1,1) GFX_RENDER_MODE(2,1,2)
+GFX_RENDER_MODE(3,0,0) GFX_RENDER_MODE(3,0,1) GFX_RENDER_MODE(3,0,2)
+GFX_RENDER_MODE(3,1,0) GFX_RENDER_MODE(3,1,1) GFX_RENDER_MODE(3,1,2)
+
+/* [stamp & map size][repeat][priority mode] */
+static void (*const gfx_render_modes[4][2][4])(uint32 bufferIndex, uint32 width) =
+{
+  {{gfx_render_000, gfx_render_001, gfx_render_002, gfx_render_none}, {gfx_render_010, gfx_render_011, gfx_render_012, gfx_render_none}},
+  {{gfx_render_100, gfx_render_101, gfx_render_102, gfx_render_none}, {gfx_render_110, gfx_render_111, gfx_render_112, gfx_render_none}},
+  {{gfx_render_200, gfx_render_201, gfx_render_202, gfx_render_none}, {gfx_render_210, gfx_render_211, gfx_render_212, gfx_render_none}},
+  {{gfx_render_300, gfx_render_301, gfx_render_302, gfx_render_none}, {gfx_render_310, gfx_render_311, gfx_render_312, gfx_render_none}}
+};
+
 void gfx_start(unsigned int base, int cycles)
 {
   /* make sure 2M mode is enabled */
@@ -701,14 +795,33 @@ void gfx_update(int cycles)
       }
     }
 
-    /* render lines */
-    while (lines--)
+    /* stamp size used for stamp map table & stamp size used for cell offset could differ if register $58 was modified */
+    if (((scd.regs[0x58>>1].byte.l >> 1) & 1) == (gfx.stampShift - 11 - 4))
+    {
+      /* select line renderer (stamp & map size, repeat and priority modes) */
+      void (*render)(uint32 bufferIndex, uint32 width) = gfx_render_modes[((gfx.dotMask >> 21) & 2) | (gfx.stampShift - 11 - 4)][scd.regs[0x58>>1].byte.l & 0x01][(scd.regs[0x02>>1].w >> 3) & 0x03];
+
+      /* render lines */
+      while (lines--)
+      {
+        /* process dots to image buffer */
+        render(gfx.bufferStart, scd.regs[0x62>>1].w);
+
+        /* increment image buffer start index for next line (8 pixels/line) */
+        gfx.bufferStart += 8;
+      }
+    }
+    else
     {
-      /* process dots to image buffer */
-      gfx_render(gfx.bufferStart, scd.regs[0x62>>1].w);
+      /* render lines */
+      while (lines--)
+      {
+        /* process dots to image buffer */
+        gfx_render(gfx.bufferStart, scd.regs[0x62>>1].w);
 
-      /* increment image buffer start index for next line (8 pixels/line) */
-      gfx.bufferStart += 8;
+        /* increment image buffer start index for next line (8 pixels/line) */
+        gfx.bufferStart += 8;
+      }
     }
   }
 }
@@ -44,6 +44,9 @@ extern int8 reset_do_not_clear_buffers;
 
 #define PCM_SCYCLES_RATIO (384 * 4)
 
+/* maximal number of samples rendered at once */
+#define PCM_BLOCK_SIZE 256
+
 #define pcm scd.pcm_hw
 
 void pcm_init(double clock, int samplerate)
@@ -159,6 +162,72 @@ static void pcm_run_silent(unsigned int length)
   pcm.cycles += length * PCM_SCYCLES_RATIO;
 }
 
+static void pcm_render_channel(chan_t *ch, int *out_l, int *out_r, unsigned int length)
+{
+  unsigned int i;
+
+  /* local copies of channel registers */
+  uint32 addr = ch->addr;
+  uint32 fd = ch->fd.w;
+  uint32 ls = ch->ls.w;
+
+  /* ENV & stereo PAN multipliers */
+  int vol_l = ch->env * (ch->pan & 0x0F);
+  int vol_r = ch->env * (ch->pan >> 4);
+
+  if (vol_l | vol_r)
+  {
+    for (i=0; i<length; i++)
+    {
+      /* read from current WAVE RAM address */
+      int data = pcm.ram[(addr >> 11) & 0xffff];
+
+      /* loop data ? */
+      if (data == 0xff)
+      {
+        /* reset WAVE RAM address */
+        addr = ls << 11;
+
+        /* read again from WAVE RAM address */
+        data = pcm.ram[ls];
+
+        /* infinite loop should not output any data (WAVE RAM address does not change anymore) */
+        if (data == 0xff) break;
+      }
+      else
+      {
+        /* increment WAVE RAM address */
+        addr += fd;
+      }
+
+      /* check sign bit (output centered around 0) */
+      data = (data & 0x80) ? (data & 0x7f) : -(data & 0x7f);
+
+      /* multiply PCM data with ENV & stereo PAN data then add to L/R outputs (14.5 fixed point) */
+      out_l[i] += ((data * vol_l) >> 5);
+      out_r[i] += ((data * vol_r) >> 5);
+    }
+  }
+  else
+  {
+    /* muted channel only updates WAVE RAM address */
+    for (i=0; i<length; i++)
+    {
+      if (pcm.ram[(addr >> 11) & 0xffff] == 0xff)
+      {
+        addr = ls << 11;
+        if (pcm.ram[ls] == 0xff) break;
+      }
+      else
+      {
+        addr += fd;
+      }
+    }
+  }
+
+  ch->addr = addr;
+}
+
 void pcm_run(unsigned int length)
 {
 #ifdef LOG_PCM
@@ -178,13 +247,24 @@ void pcm_run(unsigned int length)
   /* check if PCM chip is running */
   if (pcm.enabled)
   {
-    int i, j, l, r;
-  
-    /* generate PCM samples */
-    for (i=0; i<length; i++)
+    /* L/R outputs accumulation buffers */
+    static int out_l[PCM_BLOCK_SIZE];
+    static int out_r[PCM_BLOCK_SIZE];
+
+    unsigned int i, j, count, offset = 0;
+
+    while (offset < length)
     {
-      /* clear output */
-      l = r = 0;
+      /* process samples by blocks */
+      count = length - offset;
+      if (count > PCM_BLOCK_SIZE)
+      {
+        count = PCM_BLOCK_SIZE;
+      }
+
+      /* clear outputs */
+      memset(out_l, 0, count * sizeof(int));
+      memset(out_r, 0, count * sizeof(int));
 
       /* run eight PCM channels */
       for (j=0; j<8; j++)
@@ -192,56 +272,33 @@ void pcm_run(unsigned int length)
         /* check if channel is enabled */
         if (pcm.status & (1 << j))
         {
-          /* read from current WAVE RAM address */
-          short data = pcm.ram[(pcm.chan[j].addr >> 11) & 0xffff];
-
-          /* loop data ? */
-          if (data == 0xff)
-          {
-            /* reset WAVE RAM address */
-            pcm.chan[j].addr = pcm.chan[j].ls.w << 11;
-
-            /* read again from WAVE RAM address */
-            data = pcm.ram[pcm.chan[j].ls.w];
-          }
-          else
-          {
-            /* increment WAVE RAM address */
-            pcm.chan[j].addr += pcm.chan[j].fd.w;
-          }
-
-          /* infinite loop should not output any data */
-          if (data != 0xff)
-          {
-            /* check sign bit (output centered around 0) */
-            if (data & 0x80)
-            {
-              /* PCM data is positive */
-              data = data & 0x7f;
-            }
-            else
-            {
-              /* PCM data is negative */
-              data = -(data & 0x7f);
-            }
-
-            /* multiply PCM data with ENV & stereo PAN data then add to L/R outputs (14.5 fixed point) */
-            l += ((data * pcm.chan[j].env * (pcm.chan[j].pan & 0x0F)) >> 5);
-            r += ((data * pcm.chan[j].env * (pcm.chan[j].pan >> 4)) >> 5);
-          }
+          pcm_render_channel(&pcm.chan[j], out_l, out_r, count);
         }
       }
 
       /* limiter */
-      if (l < -32768) l = -32768;
-      else if (l > 32767) l = 32767;
-      if (r < -32768) r = -32768;
-      else if (r > 32767) r = 32767;
+      for (i=0; i<count; i++)
+      {
+        int l = out_l[i];
+        int r = out_r[i];
+        out_l[i] = (l < -32768) ? -32768 : ((l > 32767) ? 32767 : l);
+        out_r[i] = (r < -32768) ? -32768 : ((r > 32767) ? 32767 : r);
+      }
 
       /* update Blip Buffer */
-      blip_add_delta_fast(snd.blips[1], i, l-prev_l, r-prev_r);
-      prev_l = l;
-      prev_r = r;
+      for (i=0; i<count; i++)
+      {
+        int l = out_l[i];
+        int r = out_r[i];
+        if ((l - prev_l) | (r - prev_r))
+        {
+          blip_add_delta_fast(snd.blips[1], offset + i, l-prev_l, r-prev_r);
+          prev_l = l;
+          prev_r = r;
+        }
+      }
+
+      offset += count;
     }
 
     /* save last audio outputs */
@@ -267,18 +324,24 @@ void pcm_run(unsigned int length)
 }
 
 void pcm_update(unsigned int samples)
+{
+  /* run PCM chip until required samples are available */
+  pcm_stream(samples);
+
+  /* reset PCM master clocks counter */
+  pcm.cycles = 0;
+}
+
+void pcm_stream(unsigned int samples)
 {
   /* get number of internal clocks (samples) needed */
   unsigned int clocks = blip_clocks_needed(snd.blips[1], samples);
 
-  /* run PCM chip */
+  /* run PCM chip (master clocks counter is kept in sync with SUB-CPU until the end of the frame) */
   if (clocks > 0)
   {
     pcm_run(clocks);
   }
-
-  /* reset PCM master clocks counter */
-  pcm.cycles = 0;
 }
 
 void pcm_write(unsigned int address, unsigned char data)
@@ -448,8 +511,6 @@ unsigned char pcm_read(unsigned int address)
 
 void pcm_ram_dma_w(unsigned int words)
 {
-  uint16 data;
-
   /* CDC buffer source address */
   uint16 src_index = cdc.dac.w & 0x3ffe;
   
@@ -462,20 +523,7 @@ void pcm_ram_dma_w(unsigned int words)
   /* update DMA source address */
   cdc.dac.w += (words << 1);
 
-  /* DMA transfer */
-  while (words--)
-  {
-    /* read 16-bit word from CDC buffer */
-    data = *(uint16 *)(cdc.ram + src_index);
-
-    /* write 16-bit word to PCM RAM (endianness does not matter since PCM RAM is always accessed as byte)*/
-    *(uint16 *)(pcm.bank + dst_index) = data ;
-
-    /* increment CDC buffer source address */
-    src_index = (src_index + 2) & 0x3ffe;
-
-    /* increment PCM-RAM destination address */
-    dst_index = (dst_index + 2) & 0xffe;
-  }
+  /* DMA transfer (PCM RAM is always accessed as byte so data is copied as is) */
+  cdc_dma_copy(pcm.bank, dst_index, 0xffe, src_index, words, 0);
 }
 
@@ -70,6 +70,7 @@ extern void pcm_reset(void);
 extern int pcm_context_save(uint8 *state);
 extern int pcm_context_load(uint8 *state);
 extern void pcm_update(unsigned int samples);
+extern void pcm_stream(unsigned int samples);
 extern void pcm_write(unsigned int address, unsigned char data);
 extern unsigned char pcm_read(unsigned int address);
 extern void pcm_ram_dma_w(unsigned int words);
@@ -38,8 +38,44 @@
 
 #include "shared.h"
 
+#if defined(HAVE_THREADS)
+#include <pthread.h>
+#endif
+
 extern int8 reset_do_not_clear_buffers;
 
+/* MAIN-CPU can run up to 8 lines ahead of SUB-CPU when shared registers are not accessed */
+#define SYNC_LINES_MAX 8
+
+static int sync_relaxed;  /* MAIN-CPU allowed to run ahead of SUB-CPU (changes timings of SUB-CPU events within a line) */
+static int sync_lines;    /* current number of lines between CPU synchronizations */
+static int sync_pending;  /* lines already executed by MAIN-CPU but not by SUB-CPU */
+static int sync_access;   /* shared registers accessed since last line */
+
+#if defined(HAVE_THREADS)
+/* Experimental: lines executed by MAIN-CPU ahead of SUB-CPU are handed over to a      */
+/* second thread, which runs SUB-CPU & CD hardware concurrently until MAIN-CPU reaches */
+/* next synchronization. MAIN-CPU only sees SUB-CPU state through shared registers,    */
+/* which are accessed after synchronization, so execution is identical to a single     */
+/* thread. SUB-CPU accesses modifying MAIN-CPU memory map (Word-RAM mode & ownership)  */
+/* wait for MAIN-CPU to be synchronized before being processed. Lines are not handed   */
+/* over while PRG-RAM can be accessed by MAIN-CPU (SUB-CPU halted or reset) or written */
+/* by CDC DMA, since MAIN-CPU accesses to PRG-RAM are not synchronized.                */
+static pthread_t sync_thread;
+static pthread_mutex_t sync_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sync_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t sync_done = PTHREAD_COND_INITIALIZER;
+static int sync_thread_enabled;
+static int sync_thread_running;
+static int sync_thread_lines;   /* lines remaining to be executed by SUB-CPU thread */
+static int sync_thread_join;    /* MAIN-CPU is waiting for SUB-CPU thread */
+static int sync_thread_access;  /* shared registers accessed by SUB-CPU thread */
+static int sync_queued;         /* pending lines handed over to SUB-CPU thread */
+static int sync_async;          /* SUB-CPU is running on SUB-CPU thread */
+#else
+#define sync_async 0
+#endif
+
 /*--------------------------------------------------------------------------*/
 /* Unused area (return open bus data, i.e prefetched instruction word)      */
 /*--------------------------------------------------------------------------*/
@@ -80,8 +116,6 @@ static void s68k_unused_16_w(unsigned int address, unsigned int data)
 /*--------------------------------------------------------------------------*/
 void prg_ram_dma_w(unsigned int words)
 {
-  uint16 data;
-
   /* CDC buffer source address */
   uint16 src_index = cdc.dac.w & 0x3ffe;
 
@@ -100,21 +134,8 @@ void prg_ram_dma_w(unsigned int words)
     return;
   }
 
-  /* DMA transfer */
-  while (words--)
-  {
-    /* read 16-bit word from CDC RAM buffer (big-endian format) */
-    data = READ_WORD(cdc.ram, src_index);
-
-    /* write 16-bit word to PRG-RAM */
-    *(uint16 *)(scd.prg_ram + dst_index) = data ;
-
-    /* increment CDC buffer source address */
-    src_index = (src_index + 2) & 0x3ffe;
-
-    /* increment PRG-RAM destination address */
-    dst_index = (dst_index + 2) & 0x7fffe;
-  }
+  /* DMA transfer (16-bit words are read from CDC RAM buffer in big-endian format) */
+  cdc_dma_copy(scd.prg_ram, dst_index, 0x7fffe, src_index, words, 1);
 }
 
 /*--------------------------------------------------------------------------*/
@@ -442,6 +463,28 @@ static void s68k_poll_sync(unsigned int reg_mask)
   /* relative MAIN-CPU cycle counter */
   unsigned int cycles = (s68k.cycles * MCYCLES_PER_LINE) / SCYCLES_PER_LINE;
 
+#if defined(HAVE_THREADS)
+  if (sync_async)
+  {
+    /* Word-RAM mode & ownership changes are processed once MAIN-CPU is synchronized */
+    if (reg_mask & (1 << 0x03))
+    {
+      pthread_mutex_lock(&sync_lock);
+      while (!sync_thread_join)
+      {
+        pthread_cond_wait(&sync_wake, &sync_lock);
+      }
+      pthread_mutex_unlock(&sync_lock);
+    }
+
+    /* MAIN-CPU is already ahead and not idle on register polling */
+    s68k.poll.detected &= ~reg_mask;
+    m68k.poll.detected &= ~reg_mask;
+    sync_thread_access = 1;
+    return;
+  }
+#endif
+
   if (!m68k.stopped)
   {
     /* save current MAIN-CPU end cycle count (recursive execution is possible) */
@@ -470,6 +513,9 @@ static void s68k_poll_sync(unsigned int reg_mask)
   /* clear CPU register access flags */
   s68k.poll.detected &= ~reg_mask;
   m68k.poll.detected &= ~reg_mask;
+
+  /* CPU are communicating */
+  sync_access = 1;
 }
 
 /*--------------------------------------------------------------------------*/
@@ -667,7 +713,7 @@ static unsigned int scd_read_word(unsigned int address)
   /* MAIN-CPU communication words */
   if ((address & 0x1f0) == 0x10)
   {
-    if (!m68k.stopped)
+    if (!sync_async && !m68k.stopped)
     {
       /* relative MAIN-CPU cycle counter */
       unsigned int cycles = (s68k.cycles * MCYCLES_PER_LINE) / SCYCLES_PER_LINE;
@@ -1613,6 +1659,11 @@ void scd_reset(int hard)
 
     /* Reset frame cycle counter */
     scd.cycles = 0;
+
+    /* Reset CPU synchronization */
+    sync_lines = 1;
+    sync_pending = 0;
+    sync_access = 0;
   }
   else
   {
@@ -1658,7 +1709,7 @@ void scd_reset(int hard)
   pcm_reset();
 }
 
-void scd_update(unsigned int cycles)
+static void scd_run_line(unsigned int cycles)
 {
   int m68k_end_cycles;
   int s68k_run_cycles;
@@ -1676,21 +1727,25 @@ void scd_update(unsigned int cycles)
     /* CD hardware remaining cycles until end of line */
     s68k_run_cycles = s68k_end_cycles - scd.cycles;
 
+    /* default Main-CPU end cycle counter (end of line) */
+    m68k_end_cycles = cycles;
+
     /* check Timer interrupt occurence */
     if ((scd.timer > 0) && (scd.timer < s68k_run_cycles))
     {
       /* adjust Sub-CPU and Main-CPU end cycle counters up to Timer interrupt occurence */
       s68k_run_cycles = scd.timer;
-      m68k_end_cycles = mcycles_vdp + ((s68k_run_cycles * MCYCLES_PER_LINE) / SCYCLES_PER_LINE);
+      if (cycles)
+      {
+        m68k_end_cycles = mcycles_vdp + ((s68k_run_cycles * MCYCLES_PER_LINE) / SCYCLES_PER_LINE);
+      }
     }
-    else
+
+    /* run both CPU in sync until required cycle counters (MAIN-CPU is already ahead when catching up) */
+    if (cycles)
     {
-      /* default Main-CPU end cycle counter (end of line) */
-      m68k_end_cycles = cycles;
+      m68k_run(m68k_end_cycles);
     }
-
-    /* run both CPU in sync until required cycle counters */
-    m68k_run(m68k_end_cycles);
     s68k_run(scd.cycles + s68k_run_cycles);
 
     /* increment CD hardware cycle counter */
@@ -1721,6 +1776,12 @@ void scd_update(unsigned int cycles)
       }
     }
 
+    /* fast CD access: additional CD-ROM sectors can be read at 2x, 4x or 8x CDD clock rate */
+    else if ((config.cd_speed > 1) && ((cdd.cycles % ((500000 * 4) / config.cd_speed)) < (s68k_run_cycles * 3)))
+    {
+      cdd_fast_update();
+    }
+
     /* Timer */
     if (scd.timer)
     {
@@ -1743,7 +1804,7 @@ void scd_update(unsigned int cycles)
       }
     }
   }
-  while ((m68k.cycles < cycles) || (s68k.cycles < s68k_end_cycles));
+  while ((cycles && (m68k.cycles < cycles)) || (s68k.cycles < s68k_end_cycles));
 
   /* GFX processing */
   if (scd.regs[0x58>>1].byte.h & 0x80)
@@ -1753,6 +1814,186 @@ void scd_update(unsigned int cycles)
   }
 }
 
+#if defined(HAVE_THREADS)
+static void *scd_sub_thread(void *arg)
+{
+  pthread_mutex_lock(&sync_lock);
+
+  while (sync_thread_running)
+  {
+    /* wait for lines to be executed */
+    if (!sync_thread_lines)
+    {
+      pthread_cond_wait(&sync_wake, &sync_lock);
+      continue;
+    }
+
+    /* run SUB-CPU & CD hardware until end of next line */
+    pthread_mutex_unlock(&sync_lock);
+    scd_run_line(0);
+    pthread_mutex_lock(&sync_lock);
+
+    if (!--sync_thread_lines)
+    {
+      pthread_cond_signal(&sync_done);
+    }
+  }
+
+  pthread_mutex_unlock(&sync_lock);
+
+  return NULL;
+}
+
+static void scd_sub_thread_join(void)
+{
+  if (sync_async)
+  {
+    /* wait until all lines handed over to SUB-CPU thread have been executed */
+    pthread_mutex_lock(&sync_lock);
+    sync_thread_join = 1;
+    pthread_cond_signal(&sync_wake);
+    while (sync_thread_lines)
+    {
+      pthread_cond_wait(&sync_done, &sync_lock);
+    }
+    sync_thread_join = 0;
+    pthread_mutex_unlock(&sync_lock);
+
+    sync_pending -= sync_queued;
+    sync_queued = 0;
+    sync_async = 0;
+
+    /* shared registers accessed by SUB-CPU thread */
+    sync_access |= sync_thread_access;
+    sync_thread_access = 0;
+  }
+}
+#endif
+
+static void scd_catch_up(void)
+{
+#if defined(HAVE_THREADS)
+  scd_sub_thread_join();
+#endif
+
+  /* run SUB-CPU & CD hardware until start of current line */
+  while (sync_pending)
+  {
+    sync_pending--;
+    scd_run_line(0);
+  }
+}
+
+void scd_sync(void)
+{
+  /* run SUB-CPU & CD hardware until start of current line */
+  scd_catch_up();
+
+  /* shared registers accessed by MAIN-CPU */
+  sync_access = 1;
+}
+
+void scd_set_relaxed_sync(int enable)
+{
+  sync_relaxed = enable;
+}
+
+void scd_set_sub_thread(int enable)
+{
+#if defined(HAVE_THREADS)
+  sync_thread_enabled = enable;
+  if (enable)
+  {
+    scd_threads_start();
+  }
+  else
+  {
+    scd_threads_stop();
+  }
+#endif
+}
+
+void scd_threads_start(void)
+{
+#if defined(HAVE_THREADS)
+  if (sync_thread_enabled && !sync_thread_running)
+  {
+    sync_thread_running = 1;
+    if (pthread_create(&sync_thread, NULL, scd_sub_thread, NULL) != 0)
+    {
+      sync_thread_running = 0;
+    }
+  }
+#endif
+}
+
+void scd_threads_stop(void)
+{
+#if defined(HAVE_THREADS)
+  if (sync_thread_running)
+  {
+    /* lines already handed over are executed first */
+    scd_sub_thread_join();
+
+    pthread_mutex_lock(&sync_lock);
+    sync_thread_running = 0;
+    pthread_cond_signal(&sync_wake);
+    pthread_mutex_unlock(&sync_lock);
+
+    pthread_join(sync_thread, NULL);
+  }
+#endif
+}
+
+void scd_update(unsigned int cycles)
+{
+  /* adjust number of lines between CPU synchronizations */
+  if (!sync_relaxed || sync_access || m68k.stopped)
+  {
+    /* tighten synchronization as soon as CPU are communicating or MAIN-CPU waits for SUB-CPU (or when disabled) */
+    sync_access = 0;
+    sync_lines = 1;
+  }
+  else if (sync_lines < SYNC_LINES_MAX)
+  {
+    /* relax synchronization while CPU are running independently */
+    sync_lines++;
+  }
+
+  /* run MAIN-CPU ahead of SUB-CPU (except on last line of the frame) */
+  if (((sync_pending + 1) < sync_lines) && (cycles < (lines_per_frame * MCYCLES_PER_LINE)))
+  {
+#if defined(HAVE_THREADS)
+    /* hand over pending lines to SUB-CPU thread while MAIN-CPU runs ahead (unless PRG-RAM is shared) */
+    if (sync_thread_running && (sync_pending > sync_queued) &&
+        ((scd.regs[0x00].byte.l & 0x03) == 0x01) && (cdc.dma_w != prg_ram_dma_w))
+    {
+      pthread_mutex_lock(&sync_lock);
+      sync_thread_lines += (sync_pending - sync_queued);
+      sync_async = 1;
+      pthread_cond_signal(&sync_wake);
+      pthread_mutex_unlock(&sync_lock);
+      sync_queued = sync_pending;
+    }
+#endif
+
+    m68k_run(cycles);
+
+    /* MAIN-CPU idle on register polling ? */
+    if (!m68k.stopped)
+    {
+      sync_pending++;
+      return;
+    }
+  }
+
+  /* run SUB-CPU & CD hardware until start of current line */
+  scd_catch_up();
+
+  /* run both CPU in sync until end of line */
+  scd_run_line(cycles);
+}
+
 void scd_end_frame(unsigned int cycles)
 {
   /* run Stopwatch until end of frame */
@@ -1769,6 +2010,10 @@ void scd_end_frame(unsigned int cycles)
   /* reset CPU registers polling */
   m68k.poll.cycle = 0;
   s68k.poll.cycle = 0;
+
+  /* restart CPU synchronization from a single line (not saved in state) */
+  sync_lines = 1;
+  sync_access = 0;
 }
 
 int scd_context_save(uint8 *state)
@@ -86,6 +86,11 @@ typedef struct
 extern void scd_init(void);
 extern void scd_reset(int hard);
 extern void scd_update(unsigned int cycles);
+extern void scd_sync(void);
+extern void scd_set_relaxed_sync(int enable);
+extern void scd_set_sub_thread(int enable);
+extern void scd_threads_start(void);
+extern void scd_threads_stop(void);
 extern void scd_end_frame(unsigned int cycles);
 extern int scd_context_load(uint8 *state);
 extern int scd_context_save(uint8 *state);
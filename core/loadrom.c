@@ -40,6 +40,13 @@
 #include <ctype.h>
 #include "shared.h"
 
+#if defined(HAVE_MMAP)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 /*** ROM Information ***/
 #define ROMCONSOLE    256
 #define ROMCOPYRIGHT  272
@@ -94,6 +101,13 @@ uint8 romtype;
 
 static uint8 rom_region;
 
+/* shared ROM image cache */
+static char rom_cache_dir[256];
+#if defined(HAVE_MMAP)
+static uint8 *rom_map_addr;
+static size_t rom_map_size;
+#endif
+
 /***************************************************************************
  * Genesis ROM Manufacturers
  *
@@ -228,6 +242,122 @@ static void deinterleave_block(uint8 * src)
   }
 }
 
+/***************************************************************************
+ * rom_set_cache
+ *
+ * Set directory used to share loaded ROM images (NULL or empty to disable).
+ ***************************************************************************/
+void rom_set_cache(const char *dir)
+{
+  rom_cache_dir[0] = 0;
+  if (dir)
+  {
+    strncpy(rom_cache_dir, dir, sizeof(rom_cache_dir) - 1);
+    rom_cache_dir[sizeof(rom_cache_dir) - 1] = 0;
+  }
+}
+
+#if defined(HAVE_MMAP)
+/***************************************************************************
+ * rom_cache_release
+ *
+ * Restore private memory in place of shared ROM image.
+ ***************************************************************************/
+static void rom_cache_release(void)
+{
+  if (rom_map_addr)
+  {
+    mmap(rom_map_addr, rom_map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    rom_map_addr = NULL;
+    rom_map_size = 0;
+  }
+}
+
+/***************************************************************************
+ * rom_cache_map
+ *
+ * Replace loaded ROM buffer pages with a read-only mapping of the same
+ * (already byteswapped) ROM image file, shared by all running instances
+ * through the page cache. Pages written by cheats or cartridge mappers
+ * are privately copied on write.
+ ***************************************************************************/
+static void rom_cache_map(void)
+{
+  char fname[sizeof(rom_cache_dir) + 32];
+  size_t page = sysconf(_SC_PAGESIZE);
+  size_t pad = (size_t)cart.rom & (page - 1);
+  size_t head = (page - pad) & (page - 1);
+  size_t size, len;
+  struct stat st;
+  uint8 *map;
+  int fd;
+
+  /* only whole pages within ROM area can be mapped */
+  if (!rom_cache_dir[0] || (cart.romsize <= head)) return;
+  len = (cart.romsize - head) & ~(page - 1);
+  if (!len) return;
+
+  /* image file starts at same offset within page as ROM buffer */
+  size = pad + cart.romsize;
+  snprintf(fname, sizeof(fname), "%s/%08x-%x-%x.bin", rom_cache_dir, (unsigned int)crc32(0, cart.rom, cart.romsize), cart.romsize, (unsigned int)pad);
+
+  fd = open(fname, O_RDONLY);
+  if (fd < 0)
+  {
+    /* create image file (renamed once completed, in case another instance is loading same ROM) */
+    char tname[sizeof(fname) + 16];
+    uint8 *zero = (uint8 *)calloc(1, page);
+    int ok;
+    snprintf(tname, sizeof(tname), "%s.%d", fname, (int)getpid());
+    mkdir(rom_cache_dir, 0755);
+    fd = open(tname, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+      free(zero);
+      return;
+    }
+    ok = zero && (write(fd, zero, pad) == (ssize_t)pad) && (write(fd, cart.rom, cart.romsize) == (ssize_t)cart.romsize);
+    free(zero);
+    close(fd);
+    if (!ok || rename(tname, fname))
+    {
+      unlink(tname);
+      return;
+    }
+    fd = open(fname, O_RDONLY);
+    if (fd < 0) return;
+  }
+
+  /* check image file matches loaded ROM */
+  if (fstat(fd, &st) || (st.st_size != (off_t)size))
+  {
+    close(fd);
+    return;
+  }
+  map = (uint8 *)mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED)
+  {
+    close(fd);
+    return;
+  }
+  if (memcmp(map + pad, cart.rom, cart.romsize))
+  {
+    munmap(map, size);
+    close(fd);
+    return;
+  }
+  munmap(map, size);
+
+  /* map image file in place of ROM buffer pages */
+  if (mmap(cart.rom + head, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, pad + head) != MAP_FAILED)
+  {
+    rom_map_addr = cart.rom + head;
+    rom_map_size = len;
+  }
+  close(fd);
+}
+#endif
+
 /***************************************************************************
  *
  * Pass a pointer to the ROM base address.
@@ -561,6 +691,11 @@ int load_rom(char *filename)
   ggenie_shutdown();
   areplay_shutdown();
 
+#if defined(HAVE_MMAP)
+  /* release any shared ROM image */
+  rom_cache_release();
+#endif
+
   /* check previous loaded ROM size */
   if (cart.romsize > 0x800000)
   {
@@ -715,6 +850,15 @@ int load_rom(char *filename)
 
   /* Save auto-detected system hardware  */
   romtype = system_hw;
+
+#if defined(HAVE_MMAP)
+  /* ROM cartridge image */
+  if (system_hw != SYSTEM_MCD)
+  {
+    /* share ROM image with other instances */
+    rom_cache_map();
+  }
+#endif
   
   /* CD image file */
   if (system_hw == SYSTEM_MCD)
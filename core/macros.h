@@ -53,7 +53,7 @@
 #define ALIGNED_(x) __attribute__ ((aligned(x)))
 #endif
 
-/* Default CD image file access (read-only) functions */
+/* Default CD image file access functions (files are only created for disc image index) */
 /* If you need to override default stdio.h functions with custom filesystem API,
    redefine following macros in platform specific include file (osd.h) or Makefile
 */
@@ -65,6 +65,8 @@
 #define cdStreamSeek        fseek
 #define cdStreamTell        ftell
 #define cdStreamGets        fgets
+#define cdStreamCreate(fname) fopen(fname, "wb")
+#define cdStreamWrite       fwrite
 #endif
 
 #endif /* _MACROS_H_ */
@@ -345,6 +345,9 @@ unsigned int ctrl_io_read_byte(unsigned int address)
         /* register index ($A12000-A1203F mirrored up to $A120FF) */
         uint8 index = address & 0x3f;
 
+        /* run SUB-CPU until current line before accessing shared registers */
+        scd_sync();
+
         /* Memory Mode */
         if (index == 0x03)
         {
@@ -499,6 +502,9 @@ unsigned int ctrl_io_read_word(unsigned int address)
         /* register index ($A12000-A1203F mirrored up to $A120FF) */
         uint8 index = address & 0x3f;
 
+        /* run SUB-CPU until current line before accessing shared registers */
+        scd_sync();
+
         /* Memory Mode */
         if (index == 0x02)
         {
@@ -648,6 +654,9 @@ void ctrl_io_write_byte(unsigned int address, unsigned int data)
 #endif
       if (system_hw == SYSTEM_MCD)
       {
+        /* run SUB-CPU until current line before accessing shared registers */
+        scd_sync();
+
         /* register index ($A12000-A1203F mirrored up to $A120FF) */
         switch (address & 0x3f)
         {
@@ -911,6 +920,9 @@ void ctrl_io_write_word(unsigned int address, unsigned int data)
 #endif
       if (system_hw == SYSTEM_MCD)
       {
+        /* run SUB-CPU until current line before accessing shared registers */
+        scd_sync();
+
         /* register index ($A12000-A1203F mirrored up to $A120FF) */
         switch (address & 0x3e)
         {
@@ -0,0 +1,243 @@
+/***************************************************************************************
+ *  Genesis Plus
+ *  Rewind support
+ *
+ *  Copyright (C) 2007-2020  Eke-Eke (Genesis Plus GX)
+ *
+ *  Redistribution and use of this code or any derivative works are permitted
+ *  provided that the following conditions are met:
+ *
+ *   - Redistributions may not be sold, nor may they be used in a commercial
+ *     product or activity.
+ *
+ *   - Redistributions that are modified from the original source must include the
+ *     complete source code, including the source code for all components used by a
+ *     binary built from the modified sources. However, as a special exception, the
+ *     source code distributed need not include anything that is normally distributed
+ *     (in either source or binary form) with the major components (compiler, kernel,
+ *     and so on) of the operating system on which the executable runs, unless that
+ *     component itself accompanies the executable.
+ *
+ *   - Redistributions must reproduce the above copyright notice, this list of
+ *     conditions and the following disclaimer in the documentation and/or other
+ *     materials provided with the distribution.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ *  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ *  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ *  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ *  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ *  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ *  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************************/
+
+
+#include "shared.h"
+#include <zlib.h>
+
+/* compressed delta between two consecutive snapshots */
+typedef struct
+{
+  int len;              /* uncompressed delta size */
+  int zlen;             /* compressed delta size */
+} rewind_delta_t;
+
+static struct
+{
+  int budget;           /* maximal compressed history size */
+  int interval;         /* number of frames between snapshots */
+  int frames;           /* number of frames since last snapshot */
+  int size;             /* savestate size */
+  int used;             /* current compressed history size */
+  int head;             /* index of oldest snapshot */
+  int count;            /* number of snapshots in history */
+  uint8 *current;       /* last snapshot */
+  uint8 *next;          /* new snapshot */
+  uint8 *delta;         /* uncompressed delta */
+  uint8 *zbuf;          /* compressed delta */
+  uLongf zbuf_size;
+  rewind_delta_t *history[REWIND_MAX_SNAPSHOTS];
+} rwd;
+
+/* remove oldest snapshot from history */
+static void rewind_drop(void)
+{
+  rewind_delta_t *entry = rwd.history[rwd.head];
+  rwd.used -= sizeof(rewind_delta_t) + entry->zlen;
+  free(entry);
+  rwd.head = (rwd.head + 1) % REWIND_MAX_SNAPSHOTS;
+  rwd.count--;
+}
+
+void rewind_init(int budget, int interval)
+{
+  rewind_shutdown();
+
+  rwd.budget = budget;
+  rwd.interval = (interval > 0) ? interval : 1;
+  rwd.frames = rwd.interval;
+}
+
+void rewind_reset(void)
+{
+  /* clear history */
+  while (rwd.count)
+  {
+    rewind_drop();
+  }
+  rwd.head = 0;
+  rwd.used = 0;
+
+  /* release buffers (savestate size might have changed) */
+  free(rwd.current);
+  free(rwd.next);
+  free(rwd.delta);
+  free(rwd.zbuf);
+  rwd.current = rwd.next = rwd.delta = rwd.zbuf = NULL;
+  rwd.size = 0;
+
+  /* take a snapshot on next update */
+  rwd.frames = rwd.interval;
+}
+
+void rewind_shutdown(void)
+{
+  rewind_reset();
+  rwd.budget = 0;
+}
+
+void rewind_update(void)
+{
+  int len;
+  uint8 *temp;
+  uLongf zlen;
+  rewind_delta_t *entry;
+
+  /* check if rewind is enabled */
+  if (!rwd.budget)
+  {
+    return;
+  }
+
+  /* check if a snapshot should be taken */
+  if (++rwd.frames < rwd.interval)
+  {
+    return;
+  }
+  rwd.frames = 0;
+
+  /* first snapshot */
+  if (!rwd.current)
+  {
+    /* snapshot buffers must hold any savestate, size changes are detected after saving */
+    rwd.size = state_size();
+    rwd.zbuf_size = compressBound(STATE_DELTA_SIZE(rwd.size));
+    rwd.current = malloc(STATE_SIZE);
+    rwd.next = malloc(STATE_SIZE);
+    rwd.delta = malloc(STATE_DELTA_SIZE(rwd.size));
+    rwd.zbuf = malloc(rwd.zbuf_size);
+    if (!rwd.current || !rwd.next || !rwd.delta || !rwd.zbuf)
+    {
+      rewind_shutdown();
+      return;
+    }
+
+    len = state_save(rwd.current);
+    memset(rwd.current + len, 0, rwd.size - len);
+    return;
+  }
+
+  /* new snapshot */
+  len = state_save(rwd.next);
+  if (len > rwd.size)
+  {
+    /* savestate size has changed, restart history */
+    rewind_reset();
+    return;
+  }
+  memset(rwd.next + len, 0, rwd.size - len);
+
+  /* delta restoring last snapshot from new one, so that stepping back only requires one delta */
+  len = state_delta_encode(rwd.delta, rwd.current, rwd.next, rwd.size);
+  zlen = 0;
+  if (len)
+  {
+    zlen = rwd.zbuf_size;
+    if (compress2(rwd.zbuf, &zlen, rwd.delta, len, Z_BEST_SPEED) != Z_OK)
+    {
+      return;
+    }
+  }
+
+  /* remove oldest snapshots when history is full */
+  while (rwd.count && ((rwd.count == REWIND_MAX_SNAPSHOTS) || ((rwd.used + sizeof(rewind_delta_t) + zlen) > rwd.budget)))
+  {
+    rewind_drop();
+  }
+
+  /* add delta to history */
+  entry = malloc(sizeof(rewind_delta_t) + zlen);
+  if (!entry)
+  {
+    return;
+  }
+  entry->len = len;
+  entry->zlen = zlen;
+  memcpy(entry + 1, rwd.zbuf, zlen);
+  rwd.history[(rwd.head + rwd.count) % REWIND_MAX_SNAPSHOTS] = entry;
+  rwd.used += sizeof(rewind_delta_t) + zlen;
+  rwd.count++;
+
+  /* new snapshot becomes last snapshot */
+  temp = rwd.current;
+  rwd.current = rwd.next;
+  rwd.next = temp;
+}
+
+int rewind_step(void)
+{
+  uLongf len;
+  rewind_delta_t *entry;
+
+  /* check if history is empty */
+  if (!rwd.count)
+  {
+    return 0;
+  }
+
+  /* restore previous snapshot from last one */
+  rwd.count--;
+  entry = rwd.history[(rwd.head + rwd.count) % REWIND_MAX_SNAPSHOTS];
+  len = entry->len;
+  if (entry->zlen)
+  {
+    if ((uncompress(rwd.delta, &len, (uint8 *)(entry + 1), entry->zlen) != Z_OK) || (len != (uLongf)entry->len))
+    {
+      /* corrupted history, older snapshots can not be restored anymore */
+      rwd.count++;
+      rewind_reset();
+      return 0;
+    }
+  }
+  rwd.used -= sizeof(rewind_delta_t) + entry->zlen;
+  free(entry);
+  if (!state_delta_apply(rwd.current, rwd.delta, len, rwd.size))
+  {
+    rewind_reset();
+    return 0;
+  }
+
+  /* load restored snapshot */
+  rwd.frames = 0;
+  return state_load(rwd.current);
+}
+
+int rewind_count(void)
+{
+  return rwd.count;
+}
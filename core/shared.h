@@ -36,6 +36,8 @@
 #include "areplay.h"
 #include "svp.h"
 #include "state.h"
+#include "rewind.h"
+#include "branch.h"
 
 #endif /* _SHARED_H_ */
 
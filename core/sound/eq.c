@@ -42,6 +42,7 @@
 // -----------*/
 
 static double vsa = (1.0 / 4294967295.0); /* Very small amount (Denormal Fix) */
+static const float vsaf = (float)(1.0 / 4294967295.0);
 
 
 /* ---------------
@@ -130,3 +131,136 @@ double do_3band(EQSTATE * es, int sample)
 
     return (int) (l + m + h);
 }
+
+
+/* ----------------------------------------
+//| Initialise single-precision stereo EQ |
+// ----------------------------------------*/
+
+void init_3band_state_stereo(EQSTATE_STEREO * es, int lowfreq, int highfreq, int mixfreq)
+{
+    /* Clear state */
+
+    memset(es, 0, sizeof(EQSTATE_STEREO));
+
+    /* Set Low/Mid/High gains to unity */
+
+    es->lg = 1.0f;
+    es->mg = 1.0f;
+    es->hg = 1.0f;
+
+    /* Calculate filter cutoff frequencies */
+
+    es->lf = (float) (2 * sin(M_PI * ((double) lowfreq / (double) mixfreq)));
+    es->hf = (float) (2 * sin(M_PI * ((double) highfreq / (double) mixfreq)));
+}
+
+
+/* -------------------------------------------
+//| EQ a buffer of interleaved stereo samples |
+// -------------------------------------------*/
+
+/* - same filter network as do_3band, using single-precision arithmetic
+//
+// - left & right channels are processed in two independent lanes so that
+//   compilers can map them to a single SIMD register
+//
+// - output is clipped to 16-bit range and written back in place */
+
+void do_3band_stereo(EQSTATE_STEREO * es, short * buffer, int samples)
+{
+    /* Locals */
+
+    int c;
+    float lf = es->lf;
+    float hf = es->hf;
+    float lg = es->lg;
+    float mg = es->mg;
+    float hg = es->hg;
+    float f1p0[2], f1p1[2], f1p2[2], f1p3[2];
+    float f2p0[2], f2p1[2], f2p2[2], f2p3[2];
+    float sdm1[2], sdm2[2], sdm3[2];
+
+    /* Load filter state */
+
+    for (c = 0; c < 2; c++)
+    {
+        f1p0[c] = es->f1p[0][c];
+        f1p1[c] = es->f1p[1][c];
+        f1p2[c] = es->f1p[2][c];
+        f1p3[c] = es->f1p[3][c];
+        f2p0[c] = es->f2p[0][c];
+        f2p1[c] = es->f2p[1][c];
+        f2p2[c] = es->f2p[2][c];
+        f2p3[c] = es->f2p[3][c];
+        sdm1[c] = es->sdm[0][c];
+        sdm2[c] = es->sdm[1][c];
+        sdm3[c] = es->sdm[2][c];
+    }
+
+    while (samples-- > 0)
+    {
+        for (c = 0; c < 2; c++)
+        {
+            float sample = (float) buffer[c];
+            float l, m, h, out;
+
+            /* Filter #1 (lowpass) */
+
+            f1p0[c] += (lf * (sample - f1p0[c])) + vsaf;
+            f1p1[c] += (lf * (f1p0[c] - f1p1[c]));
+            f1p2[c] += (lf * (f1p1[c] - f1p2[c]));
+            f1p3[c] += (lf * (f1p2[c] - f1p3[c]));
+
+            l = f1p3[c];
+
+            /* Filter #2 (highpass) */
+
+            f2p0[c] += (hf * (sample - f2p0[c])) + vsaf;
+            f2p1[c] += (hf * (f2p0[c] - f2p1[c]));
+            f2p2[c] += (hf * (f2p1[c] - f2p2[c]));
+            f2p3[c] += (hf * (f2p2[c] - f2p3[c]));
+
+            h = sdm3[c] - f2p3[c];
+
+            /* Calculate midrange (signal - (low + high)) */
+
+            m = sample - (h + l);
+
+            /* Scale, Combine and clip */
+
+            out = (l * lg) + (m * mg) + (h * hg);
+            if (out > 32767.0f) out = 32767.0f;
+            else if (out < -32768.0f) out = -32768.0f;
+
+            /* Shuffle history buffer */
+
+            sdm3[c] = sdm2[c];
+            sdm2[c] = sdm1[c];
+            sdm1[c] = sample;
+
+            /* Store result */
+
+            buffer[c] = (short) out;
+        }
+
+        buffer += 2;
+    }
+
+    /* Save filter state */
+
+    for (c = 0; c < 2; c++)
+    {
+        es->f1p[0][c] = f1p0[c];
+        es->f1p[1][c] = f1p1[c];
+        es->f1p[2][c] = f1p2[c];
+        es->f1p[3][c] = f1p3[c];
+        es->f2p[0][c] = f2p0[c];
+        es->f2p[1][c] = f2p1[c];
+        es->f2p[2][c] = f2p2[c];
+        es->f2p[3][c] = f2p3[c];
+        es->sdm[0][c] = sdm1[c];
+        es->sdm[1][c] = sdm2[c];
+        es->sdm[2][c] = sdm3[c];
+    }
+}
@@ -54,6 +54,31 @@ typedef struct {
 
 } EQSTATE;
 
+/* Single-precision stereo version (both channels processed in parallel lanes) */
+
+typedef struct {
+    /* Filter #1 (Low band) */
+
+    float lf;           /* Frequency */
+    float f1p[4][2];    /* Poles ... */
+
+    /* Filter #2 (High band) */
+
+    float hf;           /* Frequency */
+    float f2p[4][2];    /* Poles ... */
+
+    /* Sample history buffer */
+
+    float sdm[3][2];    /* Sample data minus 1, 2, 3 */
+
+    /* Gain Controls */
+
+    float lg;           /* low  gain */
+    float mg;           /* mid  gain */
+    float hg;           /* high gain */
+
+} EQSTATE_STEREO;
+
 
 /* ---------
 //| Exports |
@@ -62,6 +87,9 @@ typedef struct {
 extern void init_3band_state(EQSTATE * es, int lowfreq, int highfreq,
            int mixfreq);
 extern double do_3band(EQSTATE * es, int sample);
+extern void init_3band_state_stereo(EQSTATE_STEREO * es, int lowfreq, int highfreq,
+           int mixfreq);
+extern void do_3band_stereo(EQSTATE_STEREO * es, short * buffer, int samples);
 
 
 #endif        /* #ifndef __EQ3BAND__ */
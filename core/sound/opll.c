@@ -554,25 +554,10 @@ void OPLL_EnvelopeOutput(opll_t *chip)
     chip->eg_out = level;
 }
 
-void OPLL_EnvelopeGenerate(opll_t *chip) {
+void OPLL_EnvelopeTimer(opll_t *chip) {
     uint8_t timer_inc;
     uint8_t timer_bit;
     uint8_t timer_low;
-    uint8_t rate;
-    uint8_t state_rate;
-    uint8_t ksr;
-    uint8_t sum;
-    uint8_t rate_hi;
-    uint8_t rate_lo;
-    int32_t level;
-    int32_t next_level;
-    uint8_t zero;
-    uint8_t state;
-    uint8_t next_state;
-    int32_t step;
-    int32_t sl;
-    uint32_t mcsel = ((chip->cycles + 1) / 3) & 0x01;
-
 
     /* EG timer */
     if ((chip->eg_counter_state & 3) != 3) {
@@ -610,6 +595,26 @@ void OPLL_EnvelopeGenerate(opll_t *chip) {
     if (chip->cycles == 17) {
         chip->eg_counter_state++;
     }
+}
+
+void OPLL_EnvelopeGenerate(opll_t *chip) {
+    uint8_t rate;
+    uint8_t state_rate;
+    uint8_t ksr;
+    uint8_t sum;
+    uint8_t rate_hi;
+    uint8_t rate_lo;
+    int32_t level;
+    int32_t next_level;
+    uint8_t zero;
+    uint8_t state;
+    uint8_t next_state;
+    int32_t step;
+    int32_t sl;
+    uint32_t mcsel = ((chip->cycles + 1) / 3) & 0x01;
+
+
+    OPLL_EnvelopeTimer(chip);
 
     level = chip->eg_level[(chip->cycles+16)%18];
     next_level = level;
@@ -1019,14 +1024,16 @@ void OPLL_DoLFO(opll_t *chip) {
 }
 
 
-void OPLL_Clock(opll_t *chip, int32_t *buffer) {
+static inline void OPLL_DoClock(opll_t *chip, int32_t *buffer, int io) {
     buffer[0] = chip->output_m;
     buffer[1] = chip->output_r;
     if (chip->cycles == 0) {
         chip->lfo_am_out = (chip->lfo_am_counter >> 3) & 0x0f;
     }
     chip->rm_enable >>= 1;
-    OPLL_DoModeWrite(chip);
+    if (io) {
+        OPLL_DoModeWrite(chip);
+    }
     chip->rm_select++;
     if (chip->rm_select > rm_num_tc) {
         chip->rm_select = rm_num_tc + 1;
@@ -1051,12 +1058,95 @@ void OPLL_Clock(opll_t *chip, int32_t *buffer) {
     OPLL_DoLFO(chip);
     OPLL_DoRhythm(chip);
     OPLL_PreparePatch2(chip);
-    OPLL_DoRegWrite(chip);
-    OPLL_DoIO(chip);
+    if (io) {
+        OPLL_DoRegWrite(chip);
+        OPLL_DoIO(chip);
+    } else if (chip->write_fm_data) {
+        /* latched register data is still applied when its slot comes up */
+        OPLL_DoRegWrite(chip);
+    }
     chip->cycles = (chip->cycles + 1) % 18;
 
 }
 
+void OPLL_Clock(opll_t *chip, int32_t *buffer) {
+    OPLL_DoClock(chip, buffer, 1);
+}
+
+/*
+ * Idle chip: rhythm & test modes off, all channels keyed off with no pending
+ * key-on, all envelopes fully released and operator pipeline drained. Output
+ * is then constant and only timers, LFO, noise and phase counters run.
+ */
+static int OPLL_IsIdle(opll_t *chip) {
+    uint32_t i;
+    int16_t out = (chip->chip_type == opll_type_ym2413b) ? 0 : 1;
+    if (chip->rm_enable || chip->testmode || chip->rm_select <= rm_num_tc
+     || chip->write_a || chip->write_d || chip->write_a_en || chip->write_d_en
+     || chip->eg_kon || chip->eg_dokon || chip->eg_off != 0xff
+     || chip->op_mod || chip->ch_out || chip->ch_out_hh || chip->ch_out_tm
+     || chip->ch_out_bd || chip->ch_out_sd || chip->ch_out_tc
+     || chip->output_m != out || chip->output_r != out) {
+        return 0;
+    }
+    if (chip->write_fm_data && (chip->address & 0xf0) == 0x20 && (chip->data & 0x10)) {
+        return 0;
+    }
+    for (i = 0; i < 9; i++) {
+        if (chip->kon[i] || chip->op_fb1[i] || chip->op_fb2[i]) {
+            return 0;
+        }
+    }
+    for (i = 0; i < 18; i++) {
+        if (chip->eg_level[i] != 0x7f || chip->eg_state[i] != eg_num_release) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static inline void OPLL_DoClockIdle(opll_t *chip, int32_t *buffer) {
+    buffer[0] = chip->output_m;
+    buffer[1] = chip->output_r;
+    if (chip->cycles == 0) {
+        chip->lfo_am_out = (chip->lfo_am_counter >> 3) & 0x0f;
+    }
+    OPLL_PhaseGenerate(chip);
+    OPLL_PhaseCalcIncrement(chip);
+    OPLL_EnvelopeTimer(chip);
+    OPLL_DoLFO(chip);
+    OPLL_DoRhythm(chip);
+    OPLL_PreparePatch2(chip);
+    if (chip->write_fm_data) {
+        OPLL_DoRegWrite(chip);
+    }
+    chip->cycles = (chip->cycles + 1) % 18;
+}
+
+void OPLL_ClockBatch(opll_t *chip, int32_t *buffer, uint32_t count) {
+    /* pending register or mode writes */
+    while (count && (chip->write_a || chip->write_d || chip->write_a_en || chip->write_d_en)) {
+        OPLL_DoClock(chip, buffer, 1);
+        buffer += 2;
+        count--;
+    }
+
+    /* no more writes until next call */
+    while (count) {
+        if (chip->cycles == 0 && OPLL_IsIdle(chip)) {
+            uint32_t n = (count < 18) ? count : 18;
+            count -= n;
+            do {
+                OPLL_DoClockIdle(chip, buffer);
+                buffer += 2;
+            } while (--n);
+        } else {
+            OPLL_DoClock(chip, buffer, 0);
+            buffer += 2;
+            count--;
+        }
+    }
+}
 
 void OPLL_Write(opll_t *chip, uint32_t port, uint8_t data) {
     chip->write_data = data;
@@ -211,5 +211,6 @@ typedef struct {
 
 void OPLL_Reset(opll_t *chip, uint32_t chip_type);
 void OPLL_Clock(opll_t *chip, int32_t *buffer);
+void OPLL_ClockBatch(opll_t *chip, int32_t *buffer, uint32_t count);
 void OPLL_Write(opll_t *chip, uint32_t port, uint8_t data);
 #endif
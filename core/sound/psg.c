@@ -91,7 +91,10 @@ static struct
   int chanDelta[4][2];
   int chanOut[4][2];
   int chanAmp[4][2];
-} psg;
+  int dcMode[3];
+  int dcOut[3][2];
+  int syncClocks;
+} psg, psg_save;
 
 static void psg_update(unsigned int clocks);
 
@@ -132,6 +135,14 @@ void psg_reset()
     psg.chanOut[i][1]   = 0;
   }
 
+  /* tone channels are not collapsed to DC on power-on */
+  for (i=0; i<3; i++)
+  {
+    psg.dcMode[i]   = 0;
+    psg.dcOut[i][0] = 0;
+    psg.dcOut[i][1] = 0;
+  }
+
   /* tone #2 attenuation register is latched on power-on (verified on 315-5313A integrated version only) */
   psg.latch = 3;
 
@@ -140,6 +151,7 @@ void psg_reset()
 
   /* reset internal M-cycles clock counter */
   psg.clocks = 0;
+  psg.syncClocks = 0;
 }
 
 int psg_context_save(uint8 *state)
@@ -178,7 +190,14 @@ int psg_context_load(uint8 *state)
   /* add current tone channels output */
   for (i=0; i<3; i++)
   {
-    if (psg.polarity[i] > 0)
+    if (psg.dcMode[i])
+    {
+      /* ultrasonic tone output is collapsed to its DC average (pending variations are kept) */
+      delta[0] -= (psg.dcOut[i][0] + psg.chanDelta[i][0]);
+      delta[1] -= (psg.dcOut[i][1] + psg.chanDelta[i][1]);
+      psg.dcMode[i] = 0;
+    }
+    else if (psg.polarity[i] > 0)
     {
       delta[0] -= psg.chanOut[i][0];
       delta[1] -= psg.chanOut[i][1];
@@ -186,6 +205,7 @@ int psg_context_load(uint8 *state)
   }
 
   load_param(&psg.clocks,sizeof(psg.clocks));
+  psg.syncClocks = 0;
   load_param(&psg.latch,sizeof(psg.latch));
   load_param(&psg.noiseShiftValue,sizeof(psg.noiseShiftValue));
   load_param(psg.regs,sizeof(psg.regs));
@@ -214,16 +234,27 @@ int psg_context_load(uint8 *state)
   /* update mixed channels output */
   if (config.hq_psg)
   {
-    blip_add_delta(snd.blips[0], psg.clocks, delta[0], delta[1]);
+    blip_add_delta(snd.blips[0], psg.clocks - snd.stream_clocks, delta[0], delta[1]);
   }
   else
   {
-    blip_add_delta_fast(snd.blips[0], psg.clocks, delta[0], delta[1]);
+    blip_add_delta_fast(snd.blips[0], psg.clocks - snd.stream_clocks, delta[0], delta[1]);
   }
 
   return bufferptr;
 }
 
+/* raw copy of PSG context, kept aside with sound buffers (see save_sound_buffer) */
+void psg_save_buffer(void)
+{
+  psg_save = psg;
+}
+
+void psg_restore_buffer(void)
+{
+  psg = psg_save;
+}
+
 void psg_write(unsigned int clocks, unsigned int data)
 {
   int index;
@@ -452,6 +483,7 @@ void psg_end_frame(unsigned int clocks)
 
   /* adjust internal M-cycles clock counter for next frame */
   psg.clocks -= clocks;
+  psg.syncClocks -= clocks;
 
   /* adjust channels time counters for next frame */
   for (i=0; i<4; ++i)
@@ -460,119 +492,236 @@ void psg_end_frame(unsigned int clocks)
   }
 }
 
+unsigned int psg_sync(unsigned int clocks)
+{
+  /* run PSG chip until requested timestamp, unless next register write is still applied at */
+  /* internal M-cycles clock counter (which is only updated on register writes, see psg_write) */
+  if (clocks > psg.clocks)
+  {
+    psg_update(clocks);
+  }
+
+  /* all channels transitions occurring before returned timestamp have been rendered */
+  return (psg.syncClocks < (int)clocks) ? ((psg.syncClocks > 0) ? psg.syncClocks : 0) : clocks;
+}
+
 static void psg_update(unsigned int clocks)
 {
-  int i, timestamp, polarity;
+  int i, timestamp, polarity, freqInc, dcPeriod;
+  int end = (int)clocks;
+  void (*add_delta)(blip_t*, unsigned, int, int);
+
+  /* blip buffer time frame may have been started within current frame (see sound_stream) */
+  int base = snd.stream_clocks;
+
+  /* all channels transitions occurring before this timestamp are rendered below */
+  psg.syncClocks = end;
+
   if (audio_hard_disable) return;
 
-  for (i=0; i<4; i++)
+  /* select blip buffer synthesis once for all channels */
+  add_delta = config.hq_psg ? blip_add_delta : blip_add_delta_fast;
+
+  /* output sample period, in M-cycles (tones with a shorter period are inaudible) */
+  dcPeriod = snd.sample_rate ? (system_clock / snd.sample_rate) : 0;
+
+  /* Tone channels */
+  for (i=0; i<3; i++)
   {
-    /* apply any pending channel volume variations */
-    if (psg.chanDelta[i][0] | psg.chanDelta[i][1])
+    int level[2];
+
+    /* timestamp of next transition */
+    timestamp = psg.freqCounter[i];
+
+    /* current channel generator polarity */
+    polarity = psg.polarity[i];
+
+    /* channel M-cycle counter increment */
+    freqInc = psg.freqInc[i];
+
+    /* channel output level currently applied to blip buffer */
+    if (psg.dcMode[i])
     {
+      level[0] = psg.dcOut[i][0];
+      level[1] = psg.dcOut[i][1];
+    }
+    else
+    {
+      level[0] = ((polarity > 0) ? psg.chanOut[i][0] : 0) - psg.chanDelta[i][0];
+      level[1] = ((polarity > 0) ? psg.chanOut[i][1] : 0) - psg.chanDelta[i][1];
+    }
+
+    /* clear pending channel volume variations */
+    psg.chanDelta[i][0] = 0;
+    psg.chanDelta[i][1] = 0;
+
+    /* ultrasonic tones (full period shorter than output sample period) are collapsed to their DC average */
+    psg.dcMode[i] = ((2 * freqInc) < dcPeriod);
+
+    if (psg.dcMode[i])
+    {
+      /* average output of a square wave toggling between 0 and channel volume */
+      psg.dcOut[i][0] = psg.chanOut[i][0] >> 1;
+      psg.dcOut[i][1] = psg.chanOut[i][1] >> 1;
+
       /* update channel output */
-      if (config.hq_psg)
+      if ((psg.dcOut[i][0] - level[0]) | (psg.dcOut[i][1] - level[1]))
       {
-        blip_add_delta(snd.blips[0], psg.clocks, psg.chanDelta[i][0], psg.chanDelta[i][1]);
+        add_delta(snd.blips[0], psg.clocks - base, psg.dcOut[i][0] - level[0], psg.dcOut[i][1] - level[1]);
       }
-      else
+    }
+    else
+    {
+      /* apply any pending channel output variations */
+      level[0] = ((polarity > 0) ? psg.chanOut[i][0] : 0) - level[0];
+      level[1] = ((polarity > 0) ? psg.chanOut[i][1] : 0) - level[1];
+      if (level[0] | level[1])
+      {
+        add_delta(snd.blips[0], psg.clocks - base, level[0], level[1]);
+      }
+
+      /* audible channel: process all transitions occurring until current clock timestamp */
+      if (psg.chanOut[i][0] | psg.chanOut[i][1])
+      {
+        while (timestamp < end)
+        {
+          /* invert tone generator polarity */
+          polarity = -polarity;
+
+          /* update channel output */
+          add_delta(snd.blips[0], timestamp - base, polarity*psg.chanOut[i][0], polarity*psg.chanOut[i][1]);
+
+          /* timestamp of next transition */
+          timestamp += freqInc;
+        }
+      }
+    }
+
+    /* silent or collapsed channel: skip directly to the first transition following current clock timestamp */
+    if (timestamp < end)
+    {
+      int count = (end - timestamp + freqInc - 1) / freqInc;
+      timestamp += count * freqInc;
+      if (count & 1)
       {
-        blip_add_delta_fast(snd.blips[0], psg.clocks, psg.chanDelta[i][0], psg.chanDelta[i][1]);
+        polarity = -polarity;
       }
+    }
+
+    /* save timestamp of next transition */
+    psg.freqCounter[i] = timestamp;
+
+    /* save channel generator polarity */
+    psg.polarity[i] = polarity;
+  }
+
+  /* Noise channel */
+  {
+    /* current noise shift register value */
+    int shiftValue = psg.noiseShiftValue;
+
+    /* apply any pending channel volume variations */
+    if (psg.chanDelta[3][0] | psg.chanDelta[3][1])
+    {
+      /* update channel output */
+      add_delta(snd.blips[0], psg.clocks - base, psg.chanDelta[3][0], psg.chanDelta[3][1]);
 
       /* clear pending channel volume variations */
-      psg.chanDelta[i][0] = 0;
-      psg.chanDelta[i][1] = 0;
+      psg.chanDelta[3][0] = 0;
+      psg.chanDelta[3][1] = 0;
     }
 
     /* timestamp of next transition */
-    timestamp = psg.freqCounter[i];
+    timestamp = psg.freqCounter[3];
 
     /* current channel generator polarity */
-    polarity = psg.polarity[i];
+    polarity = psg.polarity[3];
 
-    /* Tone channels */
-    if (i < 3)
+    /* channel M-cycle counter increment */
+    freqInc = psg.freqInc[3];
+
+    /* skip to the first positive edge (noise register is shifted on positive edge only) */
+    if ((polarity > 0) && (timestamp < end))
     {
-      /* process all transitions occurring until current clock timestamp */
-      while (timestamp < clocks)
+      polarity = -1;
+      timestamp += freqInc;
+    }
+
+    /* process all positive edges occurring until current clock timestamp */
+    if (psg.chanOut[3][0] | psg.chanOut[3][1])
+    {
+      while (timestamp < end)
       {
-        /* invert tone generator polarity */
-        polarity = -polarity;
+        /* current shift register output */
+        int shiftOutput = shiftValue & 0x01;
 
-        /* update channel output */
-        if (config.hq_psg)
+        /* White noise (-----1xx) */
+        if (psg.regs[6] & 0x04)
         {
-          blip_add_delta(snd.blips[0], timestamp, polarity*psg.chanOut[i][0], polarity*psg.chanOut[i][1]);
+          /* shift and apply XOR feedback network */
+          shiftValue = (shiftValue >> 1) | (noiseFeedback[shiftValue & psg.noiseBitMask] << psg.noiseShiftWidth);
         }
+
+        /* Periodic noise (-----0xx) */
         else
         {
-          blip_add_delta_fast(snd.blips[0], timestamp, polarity*psg.chanOut[i][0], polarity*psg.chanOut[i][1]);
+          /* shift and feedback current output */
+          shiftValue = (shiftValue >> 1) | (shiftOutput << psg.noiseShiftWidth);
+        }
+
+        /* shift register output variation */
+        shiftOutput = (shiftValue & 0x1) - shiftOutput;
+
+        /* update noise channel output */
+        if (shiftOutput)
+        {
+          add_delta(snd.blips[0], timestamp - base, shiftOutput*psg.chanOut[3][0], shiftOutput*psg.chanOut[3][1]);
+        }
+
+        /* negative edge is skipped */
+        if ((timestamp + freqInc) >= end)
+        {
+          polarity = 1;
+          timestamp += freqInc;
+          break;
         }
 
-        /* timestamp of next transition */
-        timestamp += psg.freqInc[i];
+        /* timestamp of next positive edge */
+        timestamp += 2 * freqInc;
       }
     }
-
-    /* Noise channel */
     else
     {
-      /* current noise shift register value */
-      int shiftValue = psg.noiseShiftValue;
-
-      /* process all transitions occurring until current clock timestamp */
-      while (timestamp < clocks)
+      /* silent channel: only keep shift register in sync */
+      while (timestamp < end)
       {
-        /* invert noise generator polarity */
-        polarity = -polarity;
+        if (psg.regs[6] & 0x04)
+        {
+          shiftValue = (shiftValue >> 1) | (noiseFeedback[shiftValue & psg.noiseBitMask] << psg.noiseShiftWidth);
+        }
+        else
+        {
+          shiftValue = (shiftValue >> 1) | ((shiftValue & 0x01) << psg.noiseShiftWidth);
+        }
 
-        /* noise register is shifted on positive edge only */
-        if (polarity > 0)
+        if ((timestamp + freqInc) >= end)
         {
-          /* current shift register output */
-          int shiftOutput = shiftValue & 0x01;
-
-          /* White noise (-----1xx) */
-          if (psg.regs[6] & 0x04)
-          {
-            /* shift and apply XOR feedback network */
-            shiftValue = (shiftValue >> 1) | (noiseFeedback[shiftValue & psg.noiseBitMask] << psg.noiseShiftWidth);
-          }
-
-          /* Periodic noise (-----0xx) */
-          else
-          {
-            /* shift and feedback current output */
-            shiftValue = (shiftValue >> 1) | (shiftOutput << psg.noiseShiftWidth);
-          }
-
-          /* shift register output variation */
-          shiftOutput = (shiftValue & 0x1) - shiftOutput;
-
-          /* update noise channel output */
-          if (config.hq_psg)
-          {
-            blip_add_delta(snd.blips[0], timestamp, shiftOutput*psg.chanOut[3][0], shiftOutput*psg.chanOut[3][1]);
-          }
-          else
-          {
-            blip_add_delta_fast(snd.blips[0], timestamp, shiftOutput*psg.chanOut[3][0], shiftOutput*psg.chanOut[3][1]);
-          }
+          polarity = 1;
+          timestamp += freqInc;
+          break;
         }
 
-        /* timestamp of next transition */
-        timestamp += psg.freqInc[3];
+        timestamp += 2 * freqInc;
       }
-
-      /* save shift register value */
-      psg.noiseShiftValue = shiftValue;
     }
 
+    /* save shift register value */
+    psg.noiseShiftValue = shiftValue;
+
     /* save timestamp of next transition */
-    psg.freqCounter[i] = timestamp;
+    psg.freqCounter[3] = timestamp;
 
     /* save channel generator polarity */
-    psg.polarity[i] = polarity;
+    psg.polarity[3] = polarity;
   }
-}  
+}
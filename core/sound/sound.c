@@ -236,11 +236,26 @@ static unsigned int YM3438_Read(unsigned int cycles, unsigned int a)
 #ifdef HAVE_OPLL_CORE
 static void OPLL2413_Update(int* buffer, int length)
 {
-  int i, j;
-  for (i = 0; i < length; i++)
+  int i, j, count, out;
+  while (length > 0)
   {
-    OPLL_Clock(&opll, opll_accm[opll_cycles]);
-    opll_cycles = (opll_cycles + 1) % 18;
+    /* clock OPLL up to the end of current 18-cycle period */
+    count = 18 - opll_cycles;
+    if (count > length)
+    {
+      count = length;
+    }
+    OPLL_ClockBatch(&opll, opll_accm[opll_cycles], count);
+    opll_cycles = (opll_cycles + count) % 18;
+    length -= count;
+
+    /* output is only updated on the last cycle of each period */
+    out = opll_sample * 16 * opll_status;
+    for (i = 1; i < count; i++)
+    {
+      *buffer++ = out;
+      *buffer++ = out;
+    }
     if (opll_cycles == 0)
     {
       opll_sample = 0;
@@ -248,9 +263,10 @@ static void OPLL2413_Update(int* buffer, int length)
       {
         opll_sample += opll_accm[j][0] + opll_accm[j][1];
       }
+      out = opll_sample * 16 * opll_status;
     }
-    *buffer++ = opll_sample * 16 * opll_status;
-    *buffer++ = opll_sample * 16 * opll_status;
+    *buffer++ = out;
+    *buffer++ = out;
   }
 }
 
@@ -431,10 +447,23 @@ void sound_update_fm_function_pointers(void)
   else
   {
     /* YM2413 */
-    YM_Update = (config.ym2413 & 1) ? YM2413Update : NULL;
-    fm_reset = YM2413_Reset;
-    fm_write = YM2413_Write;
-    fm_read = NULL;
+#ifdef HAVE_OPLL_CORE
+    if (config.opll)
+    {
+      /* Nuked OPLL */
+      YM_Update = (config.ym2413 & 1) ? OPLL2413_Update : NULL;
+      fm_reset = OPLL2413_Reset;
+      fm_write = OPLL2413_Write;
+      fm_read = OPLL2413_Read;
+    }
+    else
+#endif
+    {
+      YM_Update = (config.ym2413 & 1) ? YM2413Update : NULL;
+      fm_reset = YM2413_Reset;
+      fm_write = YM2413_Write;
+      fm_read = YM2413_Read;
+    }
   }
 }
 
@@ -470,34 +499,34 @@ int sound_update(unsigned int cycles)
       if (config.hq_fm)
       {
         /* high-quality Band-Limited synthesis */
-        do
+        while (time < cycles)
         {
           /* left & right channels */
           l = ((*ptr++ * preamp) / 100);
           r = ((*ptr++ * preamp) / 100);
-          blip_add_delta(snd.blips[0], time, l - prev_l, r - prev_r);
+          blip_add_delta(snd.blips[0], time - snd.stream_clocks, l - prev_l, r - prev_r);
           prev_l = l;
           prev_r = r;
 
           /* increment time counter */
           time += fm_cycles_ratio;
-        } while (time < cycles);
+        }
       }
       else
       {
         /* faster Linear Interpolation */
-        do
+        while (time < cycles)
         {
           /* left & right channels */
           l = ((*ptr++ * preamp) / 100);
           r = ((*ptr++ * preamp) / 100);
-          blip_add_delta_fast(snd.blips[0], time, l - prev_l, r - prev_r);
+          blip_add_delta_fast(snd.blips[0], time - snd.stream_clocks, l - prev_l, r - prev_r);
           prev_l = l;
           prev_r = r;
 
           /* increment time counter */
           time += fm_cycles_ratio;
-        } while (time < cycles);
+        }
       }
     }
     else
@@ -525,7 +554,85 @@ int sound_update(unsigned int cycles)
   }
 
   /* end of blip buffer time frame */
-  blip_end_frame(snd.blips[0], cycles);
+  blip_end_frame(snd.blips[0], cycles - snd.stream_clocks);
+
+  /* next blip buffer time frame starts with next frame */
+  snd.stream_clocks = 0;
+
+  /* return number of available samples */
+  return blip_samples_avail(snd.blips[0]);
+}
+
+int sound_stream(unsigned int cycles)
+{
+  /* Run PSG chip until current timestamp (PSG output may only be rendered until an earlier timestamp) */
+  cycles = psg_sync(cycles);
+
+  /* blip buffer time frame already ended at or after this timestamp */
+  if (cycles <= snd.stream_clocks)
+  {
+    return blip_samples_avail(snd.blips[0]);
+  }
+
+  /* FM chip is enabled ? */
+  if (YM_Update)
+  {
+    int prev_l, prev_r, preamp, time, l, r, *ptr;
+
+    /* Run FM chip until current timestamp */
+    fm_update(cycles);
+
+    /* FM output pre-amplification */
+    preamp = config.fm_preamp;
+
+    /* FM buffer initial timestamp */
+    time = fm_cycles_start;
+
+    /* Restore last FM outputs */
+    prev_l = fm_last[0];
+    prev_r = fm_last[1];
+
+    /* flush FM samples rendered before current timestamp */
+    for (ptr = fm_buffer; (ptr < fm_ptr) && (time < (int)cycles); ptr += 2)
+    {
+      /* left & right channels */
+      l = ((ptr[0] * preamp) / 100);
+      r = ((ptr[1] * preamp) / 100);
+
+      if (!audio_hard_disable)
+      {
+        if (config.hq_fm)
+        {
+          blip_add_delta(snd.blips[0], time - snd.stream_clocks, l - prev_l, r - prev_r);
+        }
+        else
+        {
+          blip_add_delta_fast(snd.blips[0], time - snd.stream_clocks, l - prev_l, r - prev_r);
+        }
+      }
+
+      prev_l = l;
+      prev_r = r;
+
+      /* increment time counter */
+      time += fm_cycles_ratio;
+    }
+
+    /* keep FM samples rendered ahead of current timestamp for next time frame */
+    memmove(fm_buffer, ptr, (fm_ptr - ptr) * sizeof(int));
+    fm_ptr = fm_buffer + (fm_ptr - ptr);
+
+    /* save last FM output */
+    fm_last[0] = prev_l;
+    fm_last[1] = prev_r;
+
+    /* next FM sample timestamp (FM cycle counters are only adjusted at the end of the frame) */
+    fm_cycles_start = time;
+  }
+
+  /* end of blip buffer time frame (sound chips keep counting M-cycles from the start of the frame) */
+  blip_end_frame(snd.blips[0], cycles - snd.stream_clocks);
+  snd.stream_clocks = cycles;
 
   /* return number of available samples */
   return blip_samples_avail(snd.blips[0]);
@@ -580,6 +687,37 @@ int sound_context_save(uint8 *state)
   return bufferptr;
 }
 
+int sound_context_size(uint8 *state)
+{
+  /* FM core can be changed at runtime so the largest FM context size is returned */
+  int fm_size;
+
+  if ((system_hw & SYSTEM_PBC) == SYSTEM_MD)
+  {
+    fm_size = YM2612SaveContext(state);
+#ifdef HAVE_YM3438_CORE
+    if (fm_size < (sizeof(ym3438) + sizeof(ym3438_accm) + sizeof(ym3438_sample) + sizeof(ym3438_cycles)))
+    {
+      fm_size = sizeof(ym3438) + sizeof(ym3438_accm) + sizeof(ym3438_sample) + sizeof(ym3438_cycles);
+    }
+    fm_size += sizeof(config.ym3438);
+#endif
+  }
+  else
+  {
+    fm_size = YM2413GetContextSize();
+#ifdef HAVE_OPLL_CORE
+    if (fm_size < (sizeof(opll) + sizeof(opll_accm) + sizeof(opll_sample) + sizeof(opll_cycles) + sizeof(opll_status)))
+    {
+      fm_size = sizeof(opll) + sizeof(opll_accm) + sizeof(opll_sample) + sizeof(opll_cycles) + sizeof(opll_status);
+    }
+    fm_size += sizeof(config.opll);
+#endif
+  }
+
+  return fm_size + psg_context_save(state) + sizeof(fm_cycles_start);
+}
+
 int sound_context_load(uint8 *state)
 {
   int bufferptr = 0;
@@ -643,6 +781,7 @@ void save_sound_buffer()
   snd.fm_last_save[1] = fm_last[1];
   snd.cd_last_save[0] = cdd.audio[0];
   snd.cd_last_save[1] = cdd.audio[1];
+  psg_save_buffer();
   for (i = 0; i < 3; i++)
   {
     if (snd.blips[i] != NULL)
@@ -663,6 +802,7 @@ void restore_sound_buffer()
   fm_last[1] = snd.fm_last_save[1];
   cdd.audio[0] = snd.cd_last_save[0];
   cdd.audio[1] = snd.cd_last_save[1];
+  psg_restore_buffer();
   for (i = 0; i < 3; i++)
   {
     if (snd.blips[i] != NULL && snd.blip_states[i] != NULL)
@@ -44,8 +44,10 @@
 extern void sound_init(void);
 extern void sound_reset(void);
 extern int sound_context_save(uint8 *state);
+extern int sound_context_size(uint8 *state);
 extern int sound_context_load(uint8 *state);
 extern int sound_update(unsigned int cycles);
+extern int sound_stream(unsigned int cycles);
 extern void (*fm_reset)(unsigned int cycles);
 extern void (*fm_write)(unsigned int cycles, unsigned int address, unsigned int data);
 extern unsigned int (*fm_read)(unsigned int cycles, unsigned int address);
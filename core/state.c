@@ -259,7 +259,12 @@ int state_save(unsigned char *state)
   }
 
   /* Z80 */ 
-  save_param(&Z80, sizeof(Z80_Regs));
+  {
+    /* IRQ callback is restored on load, clear it so that identical states have identical data */
+    Z80_Regs z80 = Z80;
+    z80.irq_callback = NULL;
+    save_param(&z80, sizeof(Z80_Regs));
+  }
 
   /* External HW */
   if (system_hw == SYSTEM_MCD)
@@ -286,3 +291,305 @@ int state_save(unsigned char *state)
   /* return total size */
   return bufferptr;
 }
+
+int state_size(void)
+{
+  int size = STATE_SIZE;
+  unsigned char *state = (unsigned char *)malloc(STATE_SIZE);
+
+  if (state)
+  {
+    /* savestate size for current system & cartridge hardware */
+    size = state_save(state);
+
+    /* replace current sound context size by the largest one */
+    size -= sound_context_save(state);
+    size += sound_context_size(state);
+
+    free(state);
+  }
+
+  return size;
+}
+
+/* savestate page comparison (last page can be incomplete) */
+INLINE int state_page_modified(const unsigned char *state, const unsigned char *base, int page, int size)
+{
+  size -= page * STATE_PAGE_SIZE;
+  return memcmp(state + page * STATE_PAGE_SIZE, base + page * STATE_PAGE_SIZE, (size < STATE_PAGE_SIZE) ? size : STATE_PAGE_SIZE);
+}
+
+int state_delta_encode(unsigned char *delta, const unsigned char *state, const unsigned char *base, int size)
+{
+  int page, count, len;
+  int pages = (size + STATE_PAGE_SIZE - 1) / STATE_PAGE_SIZE;
+  int bufferptr = 0;
+
+  /* only pages that differ from base state are stored, as runs of consecutive pages */
+  page = 0;
+  while (page < pages)
+  {
+    /* skip unmodified pages */
+    if (!state_page_modified(state, base, page, size))
+    {
+      page++;
+      continue;
+    }
+
+    /* count consecutive modified pages */
+    count = 1;
+    while (((page + count) < pages) && state_page_modified(state, base, page + count, size))
+    {
+      count++;
+    }
+
+    /* page run header & data */
+    len = count * STATE_PAGE_SIZE;
+    if (len > (size - page * STATE_PAGE_SIZE))
+    {
+      len = size - page * STATE_PAGE_SIZE;
+    }
+    memcpy(&delta[bufferptr], &page, 4);
+    memcpy(&delta[bufferptr + 4], &len, 4);
+    memcpy(&delta[bufferptr + 8], state + page * STATE_PAGE_SIZE, len);
+    bufferptr += 8 + len;
+    page += count;
+  }
+
+  /* return delta size */
+  return bufferptr;
+}
+
+int state_delta_apply(unsigned char *state, const unsigned char *delta, int len, int size)
+{
+  int page, count;
+  int bufferptr = 0;
+
+  /* update modified pages */
+  while (bufferptr < len)
+  {
+    /* reject truncated or corrupted delta data */
+    if ((len - bufferptr) < 8)
+    {
+      return 0;
+    }
+    memcpy(&page, &delta[bufferptr], 4);
+    memcpy(&count, &delta[bufferptr + 4], 4);
+    if ((page < 0) || (count < 0) || (page > (size / STATE_PAGE_SIZE)) ||
+        (count > (len - bufferptr - 8)) || (count > (size - page * STATE_PAGE_SIZE)))
+    {
+      return 0;
+    }
+    memcpy(state + page * STATE_PAGE_SIZE, &delta[bufferptr + 8], count);
+    bufferptr += 8 + count;
+  }
+
+  return 1;
+}
+
+int state_save_delta(unsigned char *delta, unsigned char *state, const unsigned char *base, int size)
+{
+  /* save full state, unused space is cleared so that it never appears as modified */
+  int len = state_save(state);
+  if (len > size)
+  {
+    return 0;
+  }
+  memset(state + len, 0, size - len);
+
+  return state_delta_encode(delta, state, base, size);
+}
+
+int state_load_delta(const unsigned char *delta, int len, unsigned char *state, const unsigned char *base, int size)
+{
+  /* rebuild full state from base state and modified pages */
+  memcpy(state, base, size);
+  if (!state_delta_apply(state, delta, len, size))
+  {
+    return 0;
+  }
+
+  return state_load(state);
+}
+
+/* 32-bit hash round (MurmurHash3 mixing) */
+INLINE uint32 state_hash_round(uint32 h, uint32 k)
+{
+  k *= 0xCC9E2D51;
+  k = (k << 15) | (k >> 17);
+  k *= 0x1B873593;
+  h ^= k;
+  h = (h << 13) | (h >> 19);
+  return h * 5 + 0xE6546B64;
+}
+
+/* fast 32-bit hash, using two interleaved lanes (8 bytes per step) */
+static uint32 state_hash_data(uint32 hash, const uint8 *data, int size)
+{
+  uint32 a = hash;
+  uint32 b = ~hash;
+  uint32 k0, k1;
+
+  while (size >= 8)
+  {
+    memcpy(&k0, data, 4);
+    memcpy(&k1, data + 4, 4);
+    a = state_hash_round(a, k0);
+    b = state_hash_round(b, k1);
+    data += 8;
+    size -= 8;
+  }
+
+  while (size > 0)
+  {
+    a = state_hash_round(a, *data++);
+    size--;
+  }
+
+  /* final avalanche */
+  a ^= (b << 16) | (b >> 16);
+  a ^= a >> 16;
+  a *= 0x85EBCA6B;
+  a ^= a >> 13;
+  a *= 0xC2B2AE35;
+  a ^= a >> 16;
+  return a;
+}
+
+/* VRAM patterns hash, only updated for patterns modified since last state hash */
+static uint32 vram_hash[0x800];
+static int vram_hash_init = 0;
+
+/* RAM pages hash, only updated for pages modified since last state hash. CPU writes to RAM do not go */
+/* through write handlers (unlike VDP writes to VRAM), so modified pages are found by comparing RAM  */
+/* with its copy from last state hash, which is much faster than hashing all RAM again (Sega CD).   */
+#define RAM_HASH_PAGE 0x400
+
+typedef struct
+{
+  uint8 *copy;      /* RAM copy (allocated on first use) */
+  uint32 *hash;     /* RAM pages hash */
+  int size;
+} ram_hash_t;
+
+static ram_hash_t ram_hash[5];
+
+static uint32 state_hash_ram(uint32 hash, ram_hash_t *ctx, const uint8 *ram, int size)
+{
+  int i, pages = size / RAM_HASH_PAGE;
+
+  if (ctx->size != size)
+  {
+    /* hash all pages on first use */
+    free(ctx->copy);
+    free(ctx->hash);
+    ctx->copy = malloc(size);
+    ctx->hash = malloc(pages * sizeof(uint32));
+    ctx->size = size;
+    if (!ctx->copy || !ctx->hash)
+    {
+      free(ctx->copy);
+      free(ctx->hash);
+      memset(ctx, 0, sizeof(ram_hash_t));
+      return state_hash_data(hash, ram, size);
+    }
+    memcpy(ctx->copy, ram, size);
+    for (i = 0; i < pages; i++)
+    {
+      ctx->hash[i] = state_hash_data(i, ram + i * RAM_HASH_PAGE, RAM_HASH_PAGE);
+    }
+  }
+  else
+  {
+    for (i = 0; i < pages; i++)
+    {
+      if (memcmp(ram + i * RAM_HASH_PAGE, ctx->copy + i * RAM_HASH_PAGE, RAM_HASH_PAGE))
+      {
+        memcpy(ctx->copy + i * RAM_HASH_PAGE, ram + i * RAM_HASH_PAGE, RAM_HASH_PAGE);
+        ctx->hash[i] = state_hash_data(i, ram + i * RAM_HASH_PAGE, RAM_HASH_PAGE);
+      }
+    }
+  }
+
+  return state_hash_data(hash, (uint8 *)ctx->hash, pages * sizeof(uint32));
+}
+
+/* 68000 registers hash */
+static uint32 state_hash_m68k(uint32 hash, unsigned int (*get_reg)(m68k_register_t reg), m68ki_cpu_core *cpu)
+{
+  int i;
+  uint32 regs[M68K_REG_ISP + 1];
+
+  for (i = M68K_REG_D0; i <= M68K_REG_ISP; i++)
+  {
+    regs[i] = get_reg(i);
+  }
+  hash = state_hash_data(hash, (uint8 *)regs, sizeof(regs));
+  hash = state_hash_data(hash, (uint8 *)&cpu->cycles, sizeof(cpu->cycles));
+  hash = state_hash_data(hash, (uint8 *)&cpu->int_level, sizeof(cpu->int_level));
+  return state_hash_data(hash, (uint8 *)&cpu->stopped, sizeof(cpu->stopped));
+}
+
+uint32 state_hash(void)
+{
+  int i;
+  uint32 hash;
+
+  /* VRAM is hashed per pattern, from VDP write paths modified pattern flags */
+  for (i = 0; i < 0x800; i++)
+  {
+    if (vram_dirty[i] || !vram_hash_init)
+    {
+      vram_hash[i] = state_hash_data(i, &vram[i << 5], 32);
+      vram_dirty[i] = 0;
+    }
+  }
+  vram_hash_init = 1;
+
+  /* VDP */
+  hash = state_hash_data(0, (uint8 *)vram_hash, sizeof(vram_hash));
+  hash = state_hash_data(hash, sat, sizeof(sat));
+  hash = state_hash_data(hash, cram, sizeof(cram));
+  hash = state_hash_data(hash, vsram, sizeof(vsram));
+  hash = state_hash_data(hash, reg, sizeof(reg));
+  hash = state_hash_data(hash, io_reg, sizeof(io_reg));
+
+  /* RAM & CPU registers (Z80 callbacks excluded) */
+  if ((system_hw & SYSTEM_PBC) == SYSTEM_MD)
+  {
+    hash = state_hash_ram(hash, &ram_hash[0], work_ram, sizeof(work_ram));
+    hash = state_hash_ram(hash, &ram_hash[1], zram, sizeof(zram));
+    hash = state_hash_m68k(hash, m68k_get_reg, &m68k);
+  }
+  else
+  {
+    hash = state_hash_ram(hash, &ram_hash[0], work_ram, 0x2000);
+  }
+  hash = state_hash_data(hash, (uint8 *)&Z80, (uint8 *)&Z80.daisy - (uint8 *)&Z80);
+
+  /* CD hardware RAM & CPU registers */
+  if (system_hw == SYSTEM_MCD)
+  {
+    hash = state_hash_ram(hash, &ram_hash[2], scd.prg_ram, sizeof(scd.prg_ram));
+    hash = state_hash_ram(hash, &ram_hash[3], (uint8 *)scd.word_ram, sizeof(scd.word_ram));
+    hash = state_hash_ram(hash, &ram_hash[4], scd.word_ram_2M, sizeof(scd.word_ram_2M));
+    hash = state_hash_m68k(hash, s68k_get_reg, &s68k);
+  }
+
+  return hash;
+}
+
+uint32 state_hash_full(void)
+{
+  uint32 hash = 0;
+  unsigned char *state = malloc(STATE_SIZE);
+
+  /* hash of complete savestate, for verification */
+  if (state)
+  {
+    hash = state_hash_data(0, state, state_save(state));
+    free(state);
+  }
+
+  return hash;
+}
@@ -39,9 +39,16 @@
 #ifndef _STATE_H_
 #define _STATE_H_
 
+/* maximal savestate size */
 #define STATE_SIZE    0xfd000
 #define STATE_VERSION "GENPLUS-GX 1.7.6"
 
+/* delta savestate page size */
+#define STATE_PAGE_SIZE 256
+
+/* maximal delta savestate size for a given savestate size */
+#define STATE_DELTA_SIZE(size) ((size) + 8 * ((size) / STATE_PAGE_SIZE + 1))
+
 #define load_param(param, size) \
   memcpy(param, &state[bufferptr], size); \
   bufferptr+= size;
@@ -53,5 +60,12 @@
 /* Function prototypes */
 extern int state_load(unsigned char *state);
 extern int state_save(unsigned char *state);
+extern int state_size(void);
+extern int state_delta_encode(unsigned char *delta, const unsigned char *state, const unsigned char *base, int size);
+extern int state_delta_apply(unsigned char *state, const unsigned char *delta, int len, int size);
+extern int state_save_delta(unsigned char *delta, unsigned char *state, const unsigned char *base, int size);
+extern int state_load_delta(const unsigned char *delta, int len, unsigned char *state, const unsigned char *base, int size);
+extern uint32 state_hash(void);
+extern uint32 state_hash_full(void);
 
 #endif
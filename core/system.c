@@ -54,20 +54,36 @@ uint32 system_clock;
 int16 SVP_cycles = 800; 
 
 static uint8 pause_b;
+#ifdef EQ_DOUBLE_PRECISION
 static EQSTATE eq[2];
+#else
+static EQSTATE_STEREO eq;
+#endif
 static int16 llp,rrp;
 
+/* sub-frame audio updates */
+static int stream_count;
+static int16 stream_buffer[blip_max_frame * 2];
+
+static int audio_output(int16 *buffer, int size);
+
 /******************************************************************************************/
 /* Audio subsystem                                                                        */
 /******************************************************************************************/
 
 int audio_init(int samplerate, double framerate)
 {
+  /* sub-frame audio updates settings are kept */
+  int stream_lines = snd.stream_lines;
+  void (*stream_cb)(int16 *buffer, int samples) = snd.stream_cb;
+
   /* Shutdown first */
   audio_shutdown();
 
   /* Clear the sound data context */
   memset(&snd, 0, sizeof (snd));
+  snd.stream_lines = stream_lines;
+  snd.stream_cb = stream_cb;
 
   /* Initialize Blip Buffers */
   snd.blips[0] = blip_new(samplerate / 10);
@@ -173,11 +189,19 @@ void audio_reset(void)
 
 void audio_set_equalizer(void)
 {
+#ifdef EQ_DOUBLE_PRECISION
+  /* double-precision reference implementation */
   init_3band_state(&eq[0],config.low_freq,config.high_freq,snd.sample_rate);
   init_3band_state(&eq[1],config.low_freq,config.high_freq,snd.sample_rate);
   eq[0].lg = eq[1].lg = (double)(config.lg) / 100.0;
   eq[0].mg = eq[1].mg = (double)(config.mg) / 100.0;
   eq[0].hg = eq[1].hg = (double)(config.hg) / 100.0;
+#else
+  init_3band_state_stereo(&eq,config.low_freq,config.high_freq,snd.sample_rate);
+  eq.lg = (float)(config.lg) / 100.0f;
+  eq.mg = (float)(config.mg) / 100.0f;
+  eq.hg = (float)(config.hg) / 100.0f;
+#endif
 }
 
 void audio_shutdown(void)
@@ -194,6 +218,62 @@ void audio_shutdown(void)
   }
 }
 
+void audio_set_stream(int lines, void (*callback)(int16 *buffer, int samples))
+{
+  /* sub-frame audio updates are disabled when no callback is provided */
+  snd.stream_lines = callback ? lines : 0;
+  snd.stream_cb = callback;
+  stream_count = 0;
+}
+
+static void audio_stream(void)
+{
+  /* run sound chips until current line */
+  int size = sound_stream(mcycles_vdp);
+
+#ifdef ALIGN_SND
+  /* only send an aligned number of samples if required */
+  size &= ALIGN_SND;
+#endif
+
+  if (size > 0)
+  {
+    /* Mega CD specific */
+    if (system_hw == SYSTEM_MCD)
+    {
+      /* run SUB-CPU until current line (PCM chip is updated by SUB-CPU) */
+      scd_sync();
+
+      /* run PCM chip until required samples are available */
+      pcm_stream(size);
+
+      /* read CDDA samples */
+      cdd_read_audio(size);
+    }
+
+    /* resample, mix & filter sound chips output then send it to frontend */
+    size = audio_output(stream_buffer, size);
+    if (size > 0)
+    {
+      snd.stream_cb(stream_buffer, size);
+    }
+  }
+}
+
+INLINE void audio_stream_line(void)
+{
+  /* sub-frame audio updates are enabled ? */
+  if (snd.stream_lines)
+  {
+    /* last lines of the frame are always processed by audio_update */
+    if ((++stream_count >= snd.stream_lines) && (mcycles_vdp < ((lines_per_frame - 1) * MCYCLES_PER_LINE)))
+    {
+      stream_count = 0;
+      audio_stream();
+    }
+  }
+}
+
 int audio_update(int16 *buffer)
 {
   /* run sound chips until end of frame */
@@ -207,7 +287,19 @@ int audio_update(int16 *buffer)
 
     /* read CDDA samples */
     cdd_read_audio(size);
+  }
+
+  /* restart sub-frame audio updates line counter */
+  stream_count = 0;
+
+  return audio_output(buffer, size);
+}
 
+static int audio_output(int16 *buffer, int size)
+{
+  /* Mega CD specific */
+  if (system_hw == SYSTEM_MCD)
+  {
 #ifdef ALIGN_SND
     /* return an aligned number of samples if required */
     size &= ALIGN_SND;
@@ -280,6 +372,7 @@ int audio_update(int16 *buffer)
     }
     else if (config.filter & 2)
     {
+#ifdef EQ_DOUBLE_PRECISION
       do
       {
         /* 3 Band EQ */
@@ -297,6 +390,10 @@ int audio_update(int16 *buffer)
         *out++ = r;
       }
       while (--samples);
+#else
+      /* 3 Band EQ (whole frame, both channels at once) */
+      do_3band_stereo(&eq, out, samples);
+#endif
     }
   }
 
@@ -557,6 +654,9 @@ void system_frame_gen(int do_skip)
 
     /* update VDP cycle count */
     mcycles_vdp += MCYCLES_PER_LINE;
+
+    /* sub-frame audio updates */
+    audio_stream_line();
   }
   while (++line < (lines_per_frame - 1));
   
@@ -606,6 +706,9 @@ void system_frame_gen(int do_skip)
   /* update VDP cycle count */
   mcycles_vdp += MCYCLES_PER_LINE;
 
+  /* sub-frame audio updates */
+  audio_stream_line();
+
   /* reset line count */
   line = 0;
   
@@ -665,6 +768,9 @@ void system_frame_gen(int do_skip)
 
     /* update VDP cycle count */
     mcycles_vdp += MCYCLES_PER_LINE;
+
+    /* sub-frame audio updates */
+    audio_stream_line();
   }
   while (++line < bitmap.viewport.h);
 
@@ -888,6 +994,9 @@ void system_frame_scd(int do_skip)
 
     /* update VDP cycle count */
     mcycles_vdp += MCYCLES_PER_LINE;
+
+    /* sub-frame audio updates */
+    audio_stream_line();
   }
   while (++line < (lines_per_frame - 1));
   
@@ -933,6 +1042,9 @@ void system_frame_scd(int do_skip)
   /* update VDP cycle count */
   mcycles_vdp += MCYCLES_PER_LINE;
 
+  /* sub-frame audio updates */
+  audio_stream_line();
+
   /* reset line count */
   line = 0;
   
@@ -988,6 +1100,9 @@ void system_frame_scd(int do_skip)
 
     /* update VDP cycle count */
     mcycles_vdp += MCYCLES_PER_LINE;
+
+    /* sub-frame audio updates */
+    audio_stream_line();
   }
   while (++line < bitmap.viewport.h);
 
@@ -1247,6 +1362,9 @@ void system_frame_sms(int do_skip)
 
     /* update VDP cycle count */
     mcycles_vdp += MCYCLES_PER_LINE;
+
+    /* sub-frame audio updates */
+    audio_stream_line();
   }
   while (++line < (lines_per_frame - 1));
 
@@ -1329,6 +1447,9 @@ void system_frame_sms(int do_skip)
   /* update VDP cycle count */
   mcycles_vdp += MCYCLES_PER_LINE;
 
+  /* sub-frame audio updates */
+  audio_stream_line();
+
   /* latch Vertical Scroll register */
   vscroll = reg[9];
   
@@ -1394,6 +1515,9 @@ void system_frame_sms(int do_skip)
 
     /* update VDP cycle count */
     mcycles_vdp += MCYCLES_PER_LINE;
+
+    /* sub-frame audio updates */
+    audio_stream_line();
   }
   while (++line < bitmap.viewport.h);
 
@@ -95,6 +95,9 @@ typedef struct
   blip_buffer_state_t *blip_states[3]; /* states for suspending and restoring the sound buffer */
   int fm_last_save[2];  /* For saving and restoring the sound buffer */
   int16 cd_last_save[2];  /* For saving and restoring the sound buffer */
+  unsigned int stream_clocks; /* M-cycles already resampled within current frame */
+  int stream_lines;     /* Number of lines between sub-frame audio updates (0 = disabled) */
+  void (*stream_cb)(int16 *buffer, int samples); /* Sub-frame audio samples callback */
 } t_snd;
 
 
@@ -114,6 +117,7 @@ extern void audio_reset(void);
 extern void audio_shutdown(void);
 extern int audio_update(int16 *buffer);
 extern void audio_set_equalizer(void);
+extern void audio_set_stream(int lines, void (*callback)(int16 *buffer, int samples));
 extern void system_init(void);
 extern void system_reset(void);
 extern void system_frame_gen(int do_skip);
@@ -56,6 +56,7 @@ static void vdp_set_all_vram(const uint8 *src);
     bg_name_list[bg_list_index++] = name;           \
   }                                                 \
   bg_name_dirty[name] |= (1 << ((addr >> 2) & 7));  \
+  vram_dirty[name] = 1;                             \
 }
 
 /* VDP context */
@@ -78,6 +79,7 @@ uint16 hscb;                      /* Horizontal scroll table base address */
 uint8 bg_name_dirty[0x800];       /* 1= This pattern is dirty */
 uint16 bg_name_list[0x800];       /* List of modified pattern indices */
 uint16 bg_list_index;             /* # of modified patterns in list */
+uint8 vram_dirty[0x800];          /* 1= This pattern was modified since last state hash */
 uint8 hscroll_mask;               /* Horizontal Scrolling line mask */
 uint8 playfield_shift;            /* Width of planes A, B (in bits) */
 uint8 playfield_col_mask;         /* Playfield column mask */
@@ -251,6 +253,7 @@ void vdp_reset(void)
   {
     memset((char *)sat, 0, sizeof(sat));
     memset((char *)vram, 0, sizeof(vram));
+    memset(vram_dirty, 1, sizeof(vram_dirty));
     memset((char *)cram, 0, sizeof(cram));
     memset((char *)vsram, 0, sizeof(vsram));
   }
@@ -585,6 +588,7 @@ int vdp_context_load(uint8 *state)
   {
     /* Copy all vram */
     memcpy(vram, state_vram_ptr, sizeof(vram));
+    memset(vram_dirty, 1, sizeof(vram_dirty));
     /* invalidate the tile cache */
     for (i = 0; i < bg_list_index; i++)
     {
@@ -1590,6 +1594,7 @@ static void vdp_reg_w(unsigned int r, unsigned int d, unsigned int cycles)
           
           /* make temporary copy of 16KB VRAM */
           memcpy(vram + 0x4000, vram, 0x4000);
+          memset(vram_dirty, 1, sizeof(vram_dirty));
 
           /* re-arrange 16KB VRAM address decoding */
           if (d & 0x80)
@@ -2997,6 +3002,7 @@ static void vdp_z80_data_w_sg(unsigned int data)
 
   /* VRAM write */
   vram[index] = data;
+  vram_dirty[index >> 5] = 1;
 
   /* Update address register */
   addr++;
@@ -3285,6 +3291,7 @@ static void vdp_set_all_vram(const uint8 *src)
         bg_name_list[bg_list_index++] = name;
       }
       bg_name_dirty[name] |= 0xFF;
+      vram_dirty[name] = 1;
       memcpy(vram + addr, src + addr, 32);
     }
   }
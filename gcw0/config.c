@@ -63,6 +63,7 @@ void set_config_defaults(void)
     config.addr_error     = 1;
     config.bios           = 0;
     config.lock_on        = 0; /* = OFF (can be TYPE_SK, TYPE_GG & TYPE_AR) */
+    config.cd_speed       = 1; /* = accurate CD drive timings (2, 4 or 8 = fast CD access) */
     config.ntsc           = 0;
     config.lcd            = 0; /* 0.8 fixed point */
 
@@ -123,6 +123,7 @@ void config_default(void)
   config.bios           = 0;
   config.lock_on        = 0;
   config.hot_swap       = 0;
+  config.cd_speed       = 1; /* = accurate CD drive timings (2, 4 or 8 = fast CD access) */
 
   /* video options */
   config.xshift   = 0;
@@ -72,6 +72,7 @@ typedef struct
   uint8 bios;
   uint8 lock_on;
   uint8 hot_swap;
+  uint8 cd_speed;
   uint8 invert_mouse;
   uint8 gun_cursor[2];
   uint8 overscan;
@@ -137,6 +137,7 @@ static uint8_t brm_format[0x40] =
 };
 
 static bool is_running = 0;
+static size_t serialize_size = STATE_SIZE;
 static uint8_t temp[0x10000];
 static int16 soundbuffer[3068];
 static uint16_t bitmap_data_[720 * 576];
@@ -145,6 +146,7 @@ static bool restart_eq = false;
 
 static char g_rom_dir[256];
 static char g_rom_name[256];
+static char g_rom_cache_dir[256];
 static void *g_rom_data;
 static size_t g_rom_size;
 static char *save_dir;
@@ -156,6 +158,12 @@ static retro_input_state_t input_state_cb;
 static retro_environment_t environ_cb;
 static retro_audio_sample_batch_t audio_cb;
 
+/* sub-frame audio output (see audio_set_stream) */
+static void audio_stream_cb(int16 *buffer, int samples)
+{
+   audio_cb(buffer, samples);
+}
+
 enum RetroLightgunInputModes{RetroLightgun, RetroPointer};
 static enum RetroLightgunInputModes retro_gun_mode = RetroLightgun;
 
@@ -213,6 +221,14 @@ static bool retro_audio_buff_underrun      = false;
 static unsigned audio_latency              = 0;
 static bool update_audio_latency           = false;
 
+/* Core rewind support (history size in MB, 0 if disabled) */
+static int rewind_buffer                   = 0;
+static int rewind_interval                 = 1;
+
+/* Core run-ahead support (number of frames, 0 if disabled) */
+static int runahead_frames                 = 0;
+static uint8_t *runahead_state             = NULL;
+
 #ifdef USE_PER_SOUND_CHANNELS_CONFIG
 static bool show_advanced_av_settings      = true;
 #endif
@@ -942,6 +958,7 @@ static void config_default(void)
    config.addr_error     = 1;
    config.bios           = 0;
    config.lock_on        = 0;
+   config.cd_speed       = 1;
    config.lcd            = 0; /* 0.8 fixed point */
 #ifdef HAVE_OVERCLOCK
    config.overclock      = 100;
@@ -1285,6 +1302,45 @@ static void check_variables(bool first_run)
    }
   }
 
+  var.key = "genesis_plus_gx_chd_cache";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  {
+    int hunks = !var.value ? 16 : (!strcmp(var.value, "whole image") ? 0 : atoi(var.value));
+
+    var.key = "genesis_plus_gx_chd_threads";
+    environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+    cdd_set_chd_cache(hunks, !var.value ? 1 : (!strcmp(var.value, "disabled") ? 0 : atoi(var.value)));
+  }
+
+  var.key = "genesis_plus_gx_cd_index";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  cdd_set_index(var.value && !strcmp(var.value, "enabled"));
+
+  var.key = "genesis_plus_gx_cd_preload";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  cdd_set_preload((!var.value || !strcmp(var.value, "disabled")) ? 0 : atoi(var.value));
+
+  var.key = "genesis_plus_gx_cd_relaxed_sync";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  scd_set_relaxed_sync(var.value && !strcmp(var.value, "enabled"));
+
+  var.key = "genesis_plus_gx_cd_sub_thread";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  scd_set_sub_thread(var.value && !strcmp(var.value, "enabled"));
+
+  var.key = "genesis_plus_gx_rom_cache";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  rom_set_cache((var.value && !strcmp(var.value, "enabled")) ? g_rom_cache_dir : NULL);
+
+  var.key = "genesis_plus_gx_cd_speed";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  {
+    if (!var.value)
+      config.cd_speed = 1;
+    else
+      config.cd_speed = atoi(var.value);
+  }
+
   var.key = "genesis_plus_gx_system_hw";
   environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
   {
@@ -1568,6 +1624,13 @@ static void check_variables(bool first_run)
     config.lp_range = (!var.value) ? 60 : ((atoi(var.value) * 65536) / 100);
   }
 
+  var.key = "genesis_plus_gx_audio_stream";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  {
+    int lines = (!var.value || !strcmp(var.value, "disabled")) ? 0 : atoi(var.value);
+    audio_set_stream(lines, lines ? audio_stream_cb : NULL);
+  }
+
 #if HAVE_EQ
   var.key = "genesis_plus_gx_audio_eq_low";
   environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
@@ -1661,6 +1724,27 @@ static void check_variables(bool first_run)
   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
     frameskip_threshold = strtol(var.value, NULL, 10);
 
+  var.key = "genesis_plus_gx_rewind";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  {
+    int buffer = (!var.value || !strcmp(var.value, "disabled")) ? 0 : atoi(var.value);
+
+    var.key = "genesis_plus_gx_rewind_interval";
+    environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+    orig_value = (!var.value) ? 1 : atoi(var.value);
+
+    if ((buffer != rewind_buffer) || (orig_value != rewind_interval))
+    {
+      rewind_buffer = buffer;
+      rewind_interval = orig_value;
+      rewind_init(rewind_buffer * 1024 * 1024, rewind_interval);
+    }
+  }
+
+  var.key = "genesis_plus_gx_runahead";
+  environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
+  runahead_frames = (!var.value || !strcmp(var.value, "disabled")) ? 0 : atoi(var.value);
+
   var.key = "genesis_plus_gx_blargg_ntsc_filter";
   environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var);
   {
@@ -1910,6 +1994,7 @@ static void check_variables(bool first_run)
 
   if (reinit)
   {
+    size_t size;
 #ifdef HAVE_OVERCLOCK
     overclock_delay = OVERCLOCK_FRAME_DELAY;
 #endif
@@ -1919,6 +2004,16 @@ static void check_variables(bool first_run)
     system_reset();
     memcpy(sram.sram, temp, sizeof(temp));
     update_viewports = true;
+    rewind_reset();
+
+    /* savestate size must not decrease during a session */
+    size = state_size();
+    if (size > serialize_size)
+    {
+      serialize_size = size;
+      free(runahead_state);
+      runahead_state = NULL;
+    }
   }
 
   if (update_viewports)
@@ -2502,7 +2597,15 @@ void retro_set_environment(retro_environment_t cb)
       { "genesis_plus_gx_force_dtack", "System lockups; enabled|disabled" },
       { "genesis_plus_gx_bios", "System bootrom; disabled|enabled" },
       { "genesis_plus_gx_bram", "CD System BRAM; per bios|per game" },
+      { "genesis_plus_gx_chd_cache", "CHD hunk cache; 16|1|4|8|32|64|whole image" },
+      { "genesis_plus_gx_chd_threads", "CHD decompression threads; 1|disabled|2|3|4" },
+      { "genesis_plus_gx_cd_index", "CD image index file; disabled|enabled" },
+      { "genesis_plus_gx_cd_preload", "CD image preload; disabled|256|512|1024|2048" },
+      { "genesis_plus_gx_cd_relaxed_sync", "CD CPU relaxed synchronization; disabled|enabled" },
+      { "genesis_plus_gx_cd_sub_thread", "CD Sub-CPU thread (experimental); disabled|enabled" },
+      { "genesis_plus_gx_cd_speed", "CD access speed; 1x|2x|4x|8x" },
       { "genesis_plus_gx_addr_error", "68k address error; enabled|disabled" },
+      { "genesis_plus_gx_rom_cache", "Shared ROM cache; disabled|enabled" },
       { "genesis_plus_gx_lock_on", "Cartridge lock-on; disabled|game genie|action replay (pro)|sonic & knuckles" },
       { "genesis_plus_gx_ym2413", "Master System FM (YM2413); auto|disabled|enabled" },
 #ifdef HAVE_OPLL_CORE
@@ -2517,6 +2620,7 @@ void retro_set_environment(retro_environment_t cb)
       { "genesis_plus_gx_sound_output", "Sound output; stereo|mono" },
       { "genesis_plus_gx_audio_filter", "Audio filter; disabled|low-pass" },
       { "genesis_plus_gx_lowpass_range", "Low-pass filter %; 60|65|70|75|80|85|90|95|5|10|15|20|25|30|35|40|45|50|55"},
+      { "genesis_plus_gx_audio_stream", "Sub-frame audio output (lines); disabled|16|32|64|128" },
       
       #if HAVE_EQ     
       { "genesis_plus_gx_audio_eq_low",  "EQ Low;  100|0|5|10|15|20|25|30|35|40|45|50|55|60|65|70|75|80|85|90|95" },
@@ -2537,6 +2641,9 @@ void retro_set_environment(retro_environment_t cb)
       { "genesis_plus_gx_overclock", "CPU speed; 100%|125%|150%|175%|200%" },
 #endif
       { "genesis_plus_gx_no_sprite_limit", "Remove per-line sprite limit; disabled|enabled" },
+      { "genesis_plus_gx_rewind", "Rewind history (MB); disabled|16|32|64|128|256" },
+      { "genesis_plus_gx_rewind_interval", "Rewind granularity (frames); 1|2|4|8" },
+      { "genesis_plus_gx_runahead", "Run-ahead (frames); disabled|1|2|3|4" },
       { NULL, NULL },
    };
 
@@ -2599,6 +2706,7 @@ void retro_set_environment(retro_environment_t cb)
       { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_R,     "Z" },
       { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_SELECT,    "Mode" },
       { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_START,    "Start" },
+      { 0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_L3,       "Rewind" },
 
       { 1, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_LEFT,  "D-Pad Left" },
       { 1, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_UP,    "D-Pad Up" },
@@ -2891,7 +2999,7 @@ void retro_set_controller_port_device(unsigned port, unsigned device)
    input_reset();
 }
 
-size_t retro_serialize_size(void) { return STATE_SIZE; }
+size_t retro_serialize_size(void) { return serialize_size; }
 
 extern int8 fast_savestates;
 
@@ -2912,11 +3020,14 @@ bool get_fast_savestates(void)
 
 bool retro_serialize(void *data, size_t size)
 { 
+   int len;
    fast_savestates = get_fast_savestates();
-   if (size != STATE_SIZE)
+   if (size < serialize_size)
       return FALSE;
 
-   state_save(data);
+   /* clear unused space so that identical states have identical data */
+   len = state_save(data);
+   memset((uint8_t*)data + len, 0, size - len);
    if (fast_savestates) save_sound_buffer();
 
    return TRUE;
@@ -2924,11 +3035,26 @@ bool retro_serialize(void *data, size_t size)
 
 bool retro_unserialize(const void *data, size_t size)
 {
+   int len;
    fast_savestates = get_fast_savestates();
-   if (size != STATE_SIZE)
-      return FALSE;
 
-   if (!state_load((uint8_t*)data))
+   if (size < serialize_size)
+   {
+      /* smaller states are accepted as long as they hold the whole saved data */
+      uint8_t *state = (uint8_t *)calloc(1, serialize_size);
+      if (!state)
+         return FALSE;
+      memcpy(state, data, size);
+      len = state_load(state);
+      free(state);
+   }
+   else
+   {
+      /* fixed-size (STATE_SIZE) states from older versions are still supported */
+      len = state_load((uint8_t*)data);
+   }
+
+   if ((len <= 0) || ((size_t)len > size))
       return FALSE;
 
    if (fast_savestates) restore_sound_buffer();
@@ -3058,6 +3184,7 @@ bool retro_load_game(const struct retro_game_info *info)
    snprintf(CD_BIOS_US, sizeof(CD_BIOS_US), "%s%cbios_CD_U.bin", dir, slash);
    snprintf(CD_BIOS_JP, sizeof(CD_BIOS_JP), "%s%cbios_CD_J.bin", dir, slash);
    snprintf(CART_BRAM, sizeof(CART_BRAM), "%s%ccart.brm", save_dir, slash);
+   snprintf(g_rom_cache_dir, sizeof(g_rom_cache_dir), "%s%cgenplus_rom_cache", dir, slash);
 
    check_variables(true);
 
@@ -3208,6 +3335,10 @@ bool retro_load_game(const struct retro_game_info *info)
    check_sms_border();
    is_running = false;
 
+   /* savestate size for loaded system & cartridge hardware */
+   serialize_size = state_size();
+   rewind_reset();
+
    if (system_hw == SYSTEM_MCD)
       bram_load();
 
@@ -3251,6 +3382,10 @@ void retro_unload_game(void)
    if (system_hw == SYSTEM_MCD)
       bram_save();
 
+   rewind_reset();
+   free(runahead_state);
+   runahead_state = NULL;
+   scd_set_sub_thread(0);
    audio_shutdown();
    if (md_ntsc)
       free(md_ntsc);
@@ -3352,6 +3487,7 @@ void retro_init(void)
 
 void retro_deinit(void)
 {
+   rewind_shutdown();
    libretro_supports_bitmasks = false;
 }
 
@@ -3368,12 +3504,71 @@ extern int8 audio_hard_disable;
 
 extern void sound_update_fm_function_pointers(void);
 
+static void run_frame(int do_skip)
+{
+   if (system_hw == SYSTEM_MCD)
+   {
+      system_frame_scd(do_skip);
+   }
+   else if ((system_hw & SYSTEM_PBC) == SYSTEM_MD)
+   {
+      system_frame_gen(do_skip);
+   }
+   else
+   {
+      system_frame_sms(do_skip);
+   }
+}
+
+/* Run-ahead: frames are emulated in advance (without audio output) and
+ * the last one is displayed, then emulation is restored to current frame.
+ * Only a single savestate buffer is used and sound buffers state is kept
+ * aside, the same way frontend run-ahead does with fast savestates. */
+static void run_ahead(int do_skip)
+{
+   int i;
+   int8 audio_disabled = audio_hard_disable;
+   int8 fast_savestates_save = fast_savestates;
+
+   /* snapshot current frame */
+   if (!runahead_state)
+   {
+      runahead_state = malloc(serialize_size);
+      if (!runahead_state)
+         return;
+   }
+   state_save(runahead_state);
+   save_sound_buffer();
+
+   /* emulate next frames without audio, only last one is rendered */
+   audio_hard_disable = 1;
+   sound_update_fm_function_pointers();
+   for (i = 1; i <= runahead_frames; i++)
+   {
+      run_frame((i < runahead_frames) || do_skip);
+      audio_update(soundbuffer);
+   }
+   audio_hard_disable = audio_disabled;
+   sound_update_fm_function_pointers();
+
+   /* restore current frame (emulated video & sound buffers are kept) */
+   fast_savestates = 1;
+   state_load(runahead_state);
+   fast_savestates = fast_savestates_save;
+   restore_sound_buffer();
+
+#ifdef HAVE_OVERCLOCK
+   update_overclock();
+#endif
+}
+
 void retro_run(void) 
 {
    bool okay = false;
    int result = -1;
    int do_skip = 0;
    bool updated = false;
+   bool rewinding = false;
    is_running = true;
 
 #ifdef HAVE_OVERCLOCK
@@ -3449,17 +3644,26 @@ void retro_run(void)
     update_audio_latency = false;
   }
 
-   if (system_hw == SYSTEM_MCD)
+   /* step back in core rewind history while player 1 "Rewind" input (L3 by default, remappable by frontend) is held */
+   if (rewind_buffer && input_state_cb(0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_L3))
    {
-      system_frame_scd(do_skip);
-   }
-   else if ((system_hw & SYSTEM_PBC) == SYSTEM_MD)
-   {
-      system_frame_gen(do_skip);
+      rewinding = rewind_step();
+      if (rewinding)
+      {
+#ifdef HAVE_OVERCLOCK
+         update_overclock();
+#endif
+         check_sms_border();
+      }
    }
-   else
+
+   /* current frame is still rendered as sprite collision & overflow flags are only updated during rendering */
+   run_frame(do_skip);
+
+   if (runahead_frames)
    {
-      system_frame_sms(do_skip);
+      audio_cb(soundbuffer, audio_update(soundbuffer));
+      run_ahead(do_skip);
    }
 
    if (bitmap.viewport.changed & 9)
@@ -3507,7 +3711,12 @@ void retro_run(void)
    else
      video_cb(NULL, vwidth, vheight, 720 * 2);
 
-   audio_cb(soundbuffer, audio_update(soundbuffer));
+   if (!runahead_frames)
+      audio_cb(soundbuffer, audio_update(soundbuffer));
+
+   /* snapshot taken once frame is completed (CPU cycle counters are adjusted by audio update) */
+   if (!rewinding)
+      rewind_update();
 }
 
 #undef  CHUNKSIZE
@@ -126,6 +126,102 @@ struct retro_core_option_definition option_defs_us[] = {
       },
       "per bios"
    },
+   {
+      "genesis_plus_gx_chd_cache",
+      "CHD数据块缓存",
+      "指定在内存中保留的已解压CHD数据块 (每块8个扇区) 数量. 缓存4块或以上时, 后续数据块也会在后台预先解压, 避免读取CD时卡顿. \n"
+      "‘整个镜像’会将整张光盘解压到内存中 (最多700 MB). 下次载入光盘时生效. ",
+      {
+         { "1",           NULL },
+         { "4",           NULL },
+         { "8",           NULL },
+         { "16",          NULL },
+         { "32",          NULL },
+         { "64",          NULL },
+         { "whole image", "整个镜像" },
+         { NULL, NULL },
+      },
+      "16"
+   },
+   {
+      "genesis_plus_gx_chd_threads",
+      "CHD解压线程数",
+      "指定在后台并行解压CHD数据块的线程数量. 下次载入光盘时生效. ",
+      {
+         { "disabled", "禁用" },
+         { "1",        NULL },
+         { "2",        NULL },
+         { "3",        NULL },
+         { "4",        NULL },
+         { NULL, NULL },
+      },
+      "1"
+   },
+   {
+      "genesis_plus_gx_cd_index",
+      "CD镜像索引文件",
+      "将解析后的CUE/ISO音轨列表保存到光盘镜像旁的‘.idx’文件中. 未修改的镜像之后将直接通过该文件载入, 音轨文件只在首次播放时才会打开, \n"
+      "可以加快从低速存储设备载入多音轨镜像的速度. 下次载入光盘时生效. ",
+      {
+         { "disabled", "禁用" },
+         { "enabled",  "启用" },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+   {
+      "genesis_plus_gx_cd_preload",
+      "CD镜像预载入",
+      "载入光盘时将整个镜像读入内存 (VORBIS音轨的解码和CHD镜像的解压由多个线程完成), 游戏运行时不再读取文件或解码. \n"
+      "超过所选内存上限的镜像仍然从文件读取. 下次载入光盘时生效. ",
+      {
+         { "disabled", "禁用" },
+         { "256",      "256 MB" },
+         { "512",      "512 MB" },
+         { "1024",     "1024 MB" },
+         { "2048",     "2048 MB" },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+   {
+      "genesis_plus_gx_cd_relaxed_sync",
+      "CD CPU宽松同步",
+      "CPU之间不通信时, 允许主CPU最多领先副CPU (Sub-CPU) 8行运行, 减少CPU同步次数以提高运行速度. \n"
+      "注意：副CPU定时器中断等事件在行内的时序会发生变化, 可能影响个别游戏. ",
+      {
+         { "disabled", "禁用" },
+         { "enabled",  "启用" },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+   {
+      "genesis_plus_gx_cd_sub_thread",
+      "CD副CPU独立线程 (实验性)",
+      "主CPU领先运行时, 在第二个线程中运行Sega CD副CPU (Sub-CPU), 以利用多核处理器的额外核心. \n"
+      "需要启用‘CD CPU宽松同步’. 模拟结果与单线程运行完全相同. ",
+      {
+         { "disabled", "禁用" },
+         { "enabled",  "启用" },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+   {
+      "genesis_plus_gx_cd_speed",
+      "CD读取速度",
+      "缩短Sega CD游戏的载入时间: 不模拟光驱寻道时间, 并且在CD硬件处理完上一个扇区后立即读取下一个, CD-ROM扇区读取速度最多提高到2倍、4倍或8倍. \n"
+      "选择1x以获得精确的光驱时序. ",
+      {
+         { "1x", NULL },
+         { "2x", NULL },
+         { "4x", NULL },
+         { "8x", NULL },
+         { NULL, NULL },
+      },
+      "1x"
+   },
    {
       "genesis_plus_gx_addr_error",
       "68K寻址错误",
@@ -139,6 +235,18 @@ struct retro_core_option_definition option_defs_us[] = {
       },
       "enabled"
    },
+   {
+      "genesis_plus_gx_rom_cache",
+      "共享ROM缓存",
+      "将载入的卡带ROM镜像 (已完成字节序转换) 保存到系统目录中的缓存目录, 并映射到内存中, \n"
+      "使运行同一游戏的多个实例共用一份数据. 下次载入游戏时生效. ",
+      {
+         { "disabled", "禁用" },
+         { "enabled",  "启用" },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
    {
       "genesis_plus_gx_lock_on",
       "卡带锁定",
@@ -341,6 +449,21 @@ struct retro_core_option_definition option_defs_us[] = {
       },
       "60"
    },
+   {
+      "genesis_plus_gx_audio_stream",
+      "帧内音频输出 (行)",
+      "每隔N条扫描线向前端输出一次音频, 而不是每帧输出一次, 以降低音频延迟. \n"
+      "值越小, 延迟越低, 但音频回调越频繁. ",
+      {
+         { "disabled", "禁用" },
+         { "16",       NULL },
+         { "32",       NULL },
+         { "64",       NULL },
+         { "128",      NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
 #ifdef HAVE_EQ
    {
       "genesis_plus_gx_audio_eq_low",
@@ -470,6 +593,51 @@ struct retro_core_option_definition option_defs_us[] = {
       },
       "33"
    },
+   {
+      "genesis_plus_gx_rewind",
+      "核心内倒带缓存 (MB)",
+      "在核心内部保存最近画面的压缩历史记录, 占用内存不超过所选大小. \n"
+      "按住玩家1手柄的‘倒带’键 (默认为L3, 可在前端按键映射中修改) 进行倒带. ",
+      {
+         { "disabled", "禁用" },
+         { "16",       NULL },
+         { "32",       NULL },
+         { "64",       NULL },
+         { "128",      NULL },
+         { "256",      NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+   {
+      "genesis_plus_gx_rewind_interval",
+      "倒带间隔 (帧)",
+      "两次倒带快照之间间隔的帧数. \n"
+      "值越高, 相同缓存大小可保存的历史记录越长. ",
+      {
+         { "1", NULL },
+         { "2", NULL },
+         { "4", NULL },
+         { "8", NULL },
+         { NULL, NULL },
+      },
+      "1"
+   },
+   {
+      "genesis_plus_gx_runahead",
+      "核心内预运行 (帧)",
+      "在核心内部提前模拟所选帧数, 以降低输入延迟. \n"
+      "提前模拟的帧没有声音, 并且只渲染最后一帧. 请勿与前端的预运行功能同时使用. ",
+      {
+         { "disabled", "禁用" },
+         { "1",        NULL },
+         { "2",        NULL },
+         { "3",        NULL },
+         { "4",        NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
    {
       "genesis_plus_gx_blargg_ntsc_filter",
       "Blargg NTSC滤镜",
@@ -118,6 +118,7 @@ typedef struct
   uint8 addr_error;
   uint8 bios;
   uint8 lock_on;
+  uint8 cd_speed;
   uint8 overscan;
   uint8 aspect_ratio;
   uint8 ntsc;
@@ -164,6 +165,8 @@ extern void ROMCheatUpdate(void);
 #define cdStreamSeek        rfseek
 #define cdStreamTell        rftell
 #define cdStreamGets        rfgets
+#define cdStreamCreate(fname) rfopen(fname, "wb")
+#define cdStreamWrite       rfwrite
 #endif
 
 #endif /* _OSD_H */
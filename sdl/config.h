@@ -40,6 +40,7 @@ typedef struct
   uint8 bios;
   uint8 lock_on;
   uint8 hot_swap;
+  uint8 cd_speed;
   uint8 invert_mouse;
   uint8 gun_cursor[2];
   uint8 overscan;
@@ -47,6 +48,7 @@ typedef struct
   uint8 ntsc;
   uint8 lcd;
   uint8 render;
+  uint8 rewind;
   t_input_config input[MAX_INPUTS];
 } t_config;
 
@@ -704,6 +704,7 @@ int main (int argc, char **argv)
 {
   FILE *fp;
   int running = 1;
+  int rewinding;
 
   /* Print help if no game specified */
   if(argc < 2)
@@ -854,6 +855,12 @@ int main (int argc, char **argv)
   /* reset system hardware */
   system_reset();
 
+  /* initialize rewind history */
+  if (config.rewind)
+  {
+    rewind_init(REWIND_BUFFER_SIZE, 1);
+  }
+
   if(use_sound) SDL_PauseAudio(0);
 
   /* 3 frames = 50 ms (60hz) or 60 ms (50hz) */
@@ -890,9 +897,15 @@ int main (int argc, char **argv)
       }
     }
 
+    /* hold Backspace to rewind */
+    rewinding = SDL_GetKeyboardState(NULL)[SDL_SCANCODE_BACKSPACE] && rewind_step();
+
     sdl_video_update();
     sdl_sound_update(use_sound);
 
+    if (!rewinding)
+      rewind_update();
+
     if(!turbo_mode && sdl_sync.sem_sync && sdl_video.frames_rendered % 3 == 0)
     {
       SDL_SemWait(sdl_sync.sem_sync);
@@ -938,6 +951,7 @@ int main (int argc, char **argv)
     }
   }
 
+  rewind_shutdown();
   audio_shutdown();
   error_shutdown();
 